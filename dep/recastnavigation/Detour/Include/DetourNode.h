@@ -76,6 +76,7 @@ public:
 	}
 	
 	inline int getMaxNodes() const { return m_maxNodes; }
+	inline int getNodeCount() const { return m_nodeCount; }
 	
 	inline int getHashSize() const { return m_hashSize; }
 	inline unsigned short getFirst(int bucket) const { return m_first[bucket]; }
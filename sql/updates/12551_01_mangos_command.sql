@@ -0,0 +1,8 @@
+ALTER TABLE db_version CHANGE COLUMN required_12523_01_mangos_db_script_string required_12551_01_mangos_command bit;
+
+DELETE FROM `command` WHERE name IN ('server opcodes','server opcodes dump','server opcodes reset');
+
+INSERT INTO `command` VALUES
+('server opcodes',3,'Syntax: .server opcodes [on|off]\r\n\r\nStart or stop measuring the time spent by the opcode handlers. Without argument show the state and the handlers that took the most time.'),
+('server opcodes dump',3,'Syntax: .server opcodes dump [$filename]\r\n\r\nWrite the collected opcode handler times as CSV to a file in the logs directory.'),
+('server opcodes reset',3,'Syntax: .server opcodes reset\r\n\r\nClear the collected opcode handler times.');
@@ -0,0 +1,152 @@
+/**
+ * This code is part of MaNGOS. Contributor & Copyright details are in AUTHORS/THANKS.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_DENSEIDMAP_H
+#define MANGOS_DENSEIDMAP_H
+
+#include "Platform/Define.h"
+
+#include <vector>
+#include <utility>
+
+/**
+ * Read only table of values keyed by small ids, like spell or area ids.
+ *
+ * Built from a map once it is loaded. A lookup reads the slot of the id in an array indexed by
+ * the ids and the value from the array of values, no tree or hash nodes are walked. Takes 4 bytes
+ * for each id up to the highest one plus the values.
+ */
+template<class T>
+class DenseIdMap
+{
+    public:
+        template<class Map>
+        void Build(Map const& map)
+        {
+            Clear();
+
+            uint32 maxId = 0;
+            for (typename Map::const_iterator itr = map.begin(); itr != map.end(); ++itr)
+                if (itr->first > maxId)
+                    maxId = itr->first;
+
+            if (map.empty())
+                return;
+
+            m_slots.resize(maxId + 1, 0);
+            m_values.reserve(map.size());
+            for (typename Map::const_iterator itr = map.begin(); itr != map.end(); ++itr)
+            {
+                m_values.push_back(itr->second);
+                m_slots[itr->first] = uint32(m_values.size());
+            }
+        }
+
+        void Clear()
+        {
+            std::vector<uint32>().swap(m_slots);
+            std::vector<T>().swap(m_values);
+        }
+
+        T const* Find(uint32 id) const
+        {
+            if (id >= m_slots.size() || !m_slots[id])
+                return NULL;
+
+            return &m_values[m_slots[id] - 1];
+        }
+
+        size_t size() const { return m_values.size(); }
+
+    private:
+        std::vector<uint32> m_slots;                        ///< position of the value of the id plus one, 0 for ids without value
+        std::vector<T> m_values;
+};
+
+/**
+ * Read only table of the values of a multimap keyed by small ids.
+ *
+ * The values of all ids are kept in one array ordered by id, the values of an id keep their order
+ * in the multimap. The range of an id is given by the offset of its first value and the one of
+ * the next id, so the bounds of an id are found without a search.
+ */
+template<class T>
+class DenseIdMultimap
+{
+    public:
+        typedef std::pair<uint32, T> value_type;
+        typedef value_type const* const_iterator;
+        typedef std::pair<const_iterator, const_iterator> Bounds;
+
+        template<class Multimap>
+        void Build(Multimap const& map)
+        {
+            Clear();
+
+            uint32 maxId = 0;
+            for (typename Multimap::const_iterator itr = map.begin(); itr != map.end(); ++itr)
+                if (itr->first > maxId)
+                    maxId = itr->first;
+
+            if (map.empty())
+                return;
+
+            // count the values of each id, then turn the counts into the offsets of the ranges
+            m_offsets.resize(maxId + 2, 0);
+            for (typename Multimap::const_iterator itr = map.begin(); itr != map.end(); ++itr)
+                ++m_offsets[itr->first + 1];
+
+            for (uint32 id = 1; id < m_offsets.size(); ++id)
+                m_offsets[id] += m_offsets[id - 1];
+
+            std::vector<uint32> next(m_offsets.begin(), m_offsets.end() - 1);
+            m_values.resize(map.size());
+            for (typename Multimap::const_iterator itr = map.begin(); itr != map.end(); ++itr)
+                m_values[next[itr->first]++] = value_type(itr->first, itr->second);
+        }
+
+        void Clear()
+        {
+            std::vector<uint32>().swap(m_offsets);
+            std::vector<value_type>().swap(m_values);
+        }
+
+        Bounds equal_range(uint32 id) const
+        {
+            // m_offsets has one more entry than ids, id + 1 would overflow for the highest id
+            if (m_offsets.empty() || id >= m_offsets.size() - 1)
+                return Bounds(NULL, NULL);
+
+            const_iterator base = &m_values[0];
+            return Bounds(base + m_offsets[id], base + m_offsets[id + 1]);
+        }
+
+        size_t count(uint32 id) const
+        {
+            Bounds bounds = equal_range(id);
+            return bounds.second - bounds.first;
+        }
+
+        size_t size() const { return m_values.size(); }
+
+    private:
+        std::vector<uint32> m_offsets;                      ///< index of the first value of each id, one more for the end
+        std::vector<value_type> m_values;
+};
+
+#endif
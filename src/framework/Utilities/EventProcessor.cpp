@@ -18,9 +18,12 @@
 
 #include "EventProcessor.h"
 
+#include <algorithm>
+
 EventProcessor::EventProcessor()
 {
     m_time = 0;
+    m_addCounter = 0;
     m_aborting = false;
 }
 
@@ -34,13 +37,13 @@ void EventProcessor::Update(uint32 p_time)
     // update time
     m_time += p_time;
 
-    // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    // main event loop, events may add or kill events while executed
+    while (!m_events.empty() && m_events.front().execTime <= m_time)
     {
         // get and remove event from queue
-        BasicEvent* Event = i->second;
-        m_events.erase(i);
+        BasicEvent* Event = m_events.front().event;
+        std::pop_heap(m_events.begin(), m_events.end());
+        m_events.pop_back();
 
         if (!Event->to_Abort)
         {
@@ -63,26 +66,21 @@ void EventProcessor::KillAllEvents(bool force)
     // prevent event insertions
     m_aborting = true;
 
-    // first, abort all existing events
-    for (EventList::iterator i = m_events.begin(); i != m_events.end();)
-    {
-        EventList::iterator i_old = i;
-        ++i;
-
-        i_old->second->to_Abort = true;
-        i_old->second->Abort(m_time);
-        if (force || i_old->second->IsDeletable())
-        {
-            delete i_old->second;
+    // first, abort all existing events, taken out of the queue as aborting may add new ones
+    EventList events;
+    events.swap(m_events);
 
-            if (!force)                                     // need per-element cleanup
-                m_events.erase(i_old);
-        }
+    for (EventList::const_iterator i = events.begin(); i != events.end(); ++i)
+    {
+        i->event->to_Abort = true;
+        i->event->Abort(m_time);
+        if (force || i->event->IsDeletable())
+            delete i->event;
+        else                                                // non-deletable events stay queued in their order
+            m_events.push_back(*i);
     }
 
-    // fast clear event list (in force case)
-    if (force)
-        m_events.clear();
+    std::make_heap(m_events.begin(), m_events.end());
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
@@ -91,7 +89,8 @@ void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime
         Event->m_addTime = m_time;
 
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    m_events.push_back(EventListEntry(e_time, m_addCounter++, Event));
+    std::push_heap(m_events.begin(), m_events.end());
 }
 
 uint64 EventProcessor::CalculateTime(uint64 t_offset)
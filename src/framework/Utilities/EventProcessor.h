@@ -21,7 +21,7 @@
 
 #include "Platform/Define.h"
 
-#include <map>
+#include <vector>
 
 // Note. All times are in milliseconds here.
 
@@ -55,7 +55,24 @@ class BasicEvent
         uint64 m_execTime;                                  // planned time of next execution, filled by event handler
 };
 
-typedef std::multimap<uint64, BasicEvent*> EventList;
+// queued event, events with the same execution time are executed in the order they were added
+struct EventListEntry
+{
+    EventListEntry(uint64 _execTime, uint64 _order, BasicEvent* _event) : execTime(_execTime), order(_order), event(_event) {}
+
+    // ordering of the heap, the earliest event is at the top
+    bool operator<(EventListEntry const& other) const
+    {
+        return execTime != other.execTime ? execTime > other.execTime : order > other.order;
+    }
+
+    uint64 execTime;
+    uint64 order;
+    BasicEvent* event;
+};
+
+// binary heap in a vector, its storage is kept when events are removed and reused by the next ones
+typedef std::vector<EventListEntry> EventList;
 
 class EventProcessor
 {
@@ -73,6 +90,7 @@ class EventProcessor
 
         uint64 m_time;
         EventList m_events;
+        uint64 m_addCounter;                                // order of the added events
         bool m_aborting;
 };
 
@@ -572,6 +572,8 @@ void WorldSession::HandlePlayerLoginOpcode(WorldPacket& recv_data)
         return;
     }
 
+    // must see the save of a logout just before
+    SqlAsyncOrderGuard orderGuard(CharacterDatabase, playerGuid.GetRawValue());
     CharacterDatabase.DelayQueryHolder(&chrHandler, &CharacterHandler::HandlePlayerLoginCallback, holder);
 }
 
@@ -982,6 +984,14 @@ void WorldSession::HandleChangePlayerNameOpcodeCallBack(QueryResult* result, uin
     CharacterDatabase.PExecute("DELETE FROM character_declinedname WHERE guid ='%u'", guidLow);
     CharacterDatabase.CommitTransaction();
 
+    CharacterNameData nameData;
+    if (sObjectMgr.GetCharacterNameData(guidLow, nameData))
+    {
+        nameData.name = newname;
+        sObjectMgr.SetCharacterNameData(guidLow, nameData);
+    }
+    sObjectMgr.SetCharacterDeclinedNames(guidLow, NULL);
+
     sLog.outChar("Account: %d (IP: %s) Character:[%s] (guid:%u) Changed name to: %s", session->GetAccountId(), session->GetRemoteAddress().c_str(), oldname.c_str(), guidLow, newname.c_str());
 
     WorldPacket data(SMSG_CHAR_RENAME, 1 + 8 + (newname.size() + 1));
@@ -1063,6 +1073,8 @@ void WorldSession::HandleSetPlayerDeclinedNamesOpcode(WorldPacket& recv_data)
         return;
     }
 
+    sObjectMgr.SetCharacterDeclinedNames(guid.GetCounter(), &declinedname);
+
     for (int i = 0; i < MAX_DECLINED_NAME_CASES; ++i)
         CharacterDatabase.escape_string(declinedname.name[i]);
 
@@ -1225,6 +1237,15 @@ void WorldSession::HandleCharCustomizeOpcode(WorldPacket& recv_data)
         return;
     }
 
+    CharacterNameData nameData;
+    if (sObjectMgr.GetCharacterNameData(guid.GetCounter(), nameData))
+    {
+        nameData.name = newname;
+        nameData.gender = gender;
+        sObjectMgr.SetCharacterNameData(guid.GetCounter(), nameData);
+    }
+    sObjectMgr.SetCharacterDeclinedNames(guid.GetCounter(), NULL);
+
     CharacterDatabase.escape_string(newname);
     Player::Customize(guid, gender, skin, face, hairStyle, hairColor, facialHair);
     CharacterDatabase.PExecute("UPDATE characters set name = '%s', at_login = at_login & ~ %u WHERE guid ='%u'", newname.c_str(), uint32(AT_LOGIN_CUSTOMIZE), guid.GetCounter());
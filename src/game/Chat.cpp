@@ -665,6 +665,14 @@ ChatCommand* ChatHandler::getCommandTable()
         { NULL,             0,                  false, NULL,                                           "", NULL }
     };
 
+    static ChatCommand serverOpcodesCommandTable[] =
+    {
+        { "dump",           SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerOpcodesDumpCommand,   "", NULL },
+        { "reset",          SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerOpcodesResetCommand,  "", NULL },
+        { "",               SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerOpcodesCommand,       "", NULL },
+        { NULL,             0,                  false, NULL,                                           "", NULL }
+    };
+
     static ChatCommand serverSetCommandTable[] =
     {
         { "motd",           SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerSetMotdCommand,       "", NULL },
@@ -680,6 +688,7 @@ ChatCommand* ChatHandler::getCommandTable()
         { "info",           SEC_PLAYER,         true,  &ChatHandler::HandleServerInfoCommand,          "", NULL },
         { "log",            SEC_CONSOLE,        true,  NULL,                                           "", serverLogCommandTable },
         { "motd",           SEC_PLAYER,         true,  &ChatHandler::HandleServerMotdCommand,          "", NULL },
+        { "opcodes",        SEC_ADMINISTRATOR,  true,  NULL,                                           "", serverOpcodesCommandTable },
         { "plimit",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerPLimitCommand,        "", NULL },
         { "restart",        SEC_ADMINISTRATOR,  true,  NULL,                                           "", serverRestartCommandTable },
         { "shutdown",       SEC_ADMINISTRATOR,  true,  NULL,                                           "", serverShutdownCommandTable },
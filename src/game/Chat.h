@@ -503,6 +503,9 @@ class MANGOS_DLL_SPEC ChatHandler
         bool HandleServerLogFilterCommand(char* args);
         bool HandleServerLogLevelCommand(char* args);
         bool HandleServerMotdCommand(char* args);
+        bool HandleServerOpcodesCommand(char* args);
+        bool HandleServerOpcodesDumpCommand(char* args);
+        bool HandleServerOpcodesResetCommand(char* args);
         bool HandleServerPLimitCommand(char* args);
         bool HandleServerRestartCommand(char* args);
         bool HandleServerSetMotdCommand(char* args);
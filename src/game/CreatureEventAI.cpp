@@ -658,9 +658,11 @@ void CreatureEventAI::ProcessAction(CreatureEventAI_Action const& action, uint32
             break;
         case ACTION_T_THREAT_ALL_PCT:
         {
-            ThreatList const& threatList = m_creature->getThreatManager().getThreatList();
-            for (ThreatList::const_iterator i = threatList.begin(); i != threatList.end(); ++i)
-                if (Unit* Temp = m_creature->GetMap()->GetUnit((*i)->getUnitGuid()))
+            // references below -100% are removed from the list
+            GuidVector threatGuids;
+            m_creature->FillGuidsListFromThreatList(threatGuids);
+            for (GuidVector::const_iterator i = threatGuids.begin(); i != threatGuids.end(); ++i)
+                if (Unit* Temp = m_creature->GetMap()->GetUnit(*i))
                     m_creature->getThreatManager().modifyThreatPercent(Temp, action.threat_all_pct.percent);
             break;
         }
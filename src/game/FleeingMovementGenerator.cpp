@@ -44,9 +44,20 @@ void FleeingMovementGenerator<T>::_setTargetLocation(T& owner)
 
     owner.addUnitState(UNIT_STAT_FLEEING_MOVE);
 
-    PathFinder path(&owner);
-    path.setPathLengthLimit(30.0f);
-    path.calculate(x, y, z);
+    // with path threads the owner starts running in Update() once the path is calculated
+    PathFinder* path = new PathFinder(&owner);
+    path->setPathLengthLimit(30.0f);
+    if (i_pathRequest.Request(path, x, y, z))
+        return;
+
+    path->calculate(x, y, z);
+    _moveByPath(owner, *path);
+    delete path;
+}
+
+template<class T>
+void FleeingMovementGenerator<T>::_moveByPath(T& owner, PathFinder& path)
+{
     if (path.getPathType() & PATHFIND_NOPATH)
     {
         i_nextCheckTime.Reset(urand(1000, 1500));
@@ -128,6 +139,7 @@ void FleeingMovementGenerator<T>::Initialize(T& owner)
 template<>
 void FleeingMovementGenerator<Player>::Finalize(Player& owner)
 {
+    i_pathRequest.Cancel();
     owner.clearUnitState(UNIT_STAT_FLEEING | UNIT_STAT_FLEEING_MOVE);
     owner.StopMoving();
 }
@@ -135,12 +147,14 @@ void FleeingMovementGenerator<Player>::Finalize(Player& owner)
 template<>
 void FleeingMovementGenerator<Creature>::Finalize(Creature& owner)
 {
+    i_pathRequest.Cancel();
     owner.clearUnitState(UNIT_STAT_FLEEING | UNIT_STAT_FLEEING_MOVE);
 }
 
 template<class T>
 void FleeingMovementGenerator<T>::Interrupt(T& owner)
 {
+    i_pathRequest.Cancel();
     owner.InterruptMoving();
     // flee state still applied while movegen disabled
     owner.clearUnitState(UNIT_STAT_FLEEING_MOVE);
@@ -165,6 +179,15 @@ bool FleeingMovementGenerator<T>::Update(T& owner, const uint32& time_diff)
         return true;
     }
 
+    if (PathFinder* path = i_pathRequest.TakeResult(owner))
+    {
+        _moveByPath(owner, *path);
+        delete path;
+    }
+
+    if (i_pathRequest.IsPending())
+        return true;
+
     i_nextCheckTime.Update(time_diff);
     if (i_nextCheckTime.Passed() && owner.movespline->Finalized())
         _setTargetLocation(owner);
@@ -178,6 +201,8 @@ template bool FleeingMovementGenerator<Player>::_getPoint(Player&, float&, float
 template bool FleeingMovementGenerator<Creature>::_getPoint(Creature&, float&, float&, float&);
 template void FleeingMovementGenerator<Player>::_setTargetLocation(Player&);
 template void FleeingMovementGenerator<Creature>::_setTargetLocation(Creature&);
+template void FleeingMovementGenerator<Player>::_moveByPath(Player&, PathFinder&);
+template void FleeingMovementGenerator<Creature>::_moveByPath(Creature&, PathFinder&);
 template void FleeingMovementGenerator<Player>::Interrupt(Player&);
 template void FleeingMovementGenerator<Creature>::Interrupt(Creature&);
 template void FleeingMovementGenerator<Player>::Reset(Player&);
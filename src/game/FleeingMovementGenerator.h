@@ -21,6 +21,7 @@
 
 #include "MovementGenerator.h"
 #include "ObjectGuid.h"
+#include "PathRequestService.h"
 
 template<class T>
 class MANGOS_DLL_SPEC FleeingMovementGenerator
@@ -40,9 +41,11 @@ class MANGOS_DLL_SPEC FleeingMovementGenerator
     private:
         void _setTargetLocation(T& owner);
         bool _getPoint(T& owner, float& x, float& y, float& z);
+        void _moveByPath(T& owner, PathFinder& path);
 
         ObjectGuid i_frightGuid;
         TimeTracker i_nextCheckTime;
+        PathRequestHandle i_pathRequest;
 };
 
 class MANGOS_DLL_SPEC TimedFleeingMovementGenerator
@@ -29,6 +29,8 @@
 #include "World.h"
 #include "Policies/Singleton.h"
 #include "Util.h"
+#include "Timer.h"
+#include "ace/Mem_Map.h"
 
 char const* MAP_MAGIC         = "MAPS";
 char const* MAP_VERSION_MAGIC = "v1.3";
@@ -36,6 +38,16 @@ char const* MAP_AREA_MAGIC    = "AREA";
 char const* MAP_HEIGHT_MAGIC  = "MHGT";
 char const* MAP_LIQUID_MAGIC  = "MLIQ";
 
+enum GridMapArray
+{
+    GRID_MAP_ARRAY_AREA         = 0x01,
+    GRID_MAP_ARRAY_V9           = 0x02,
+    GRID_MAP_ARRAY_V8           = 0x04,
+    GRID_MAP_ARRAY_LIQUID_ENTRY = 0x08,
+    GRID_MAP_ARRAY_LIQUID_FLAGS = 0x10,
+    GRID_MAP_ARRAY_LIQUID_MAP   = 0x20
+};
+
 GridMap::GridMap()
 {
     m_flags = 0;
@@ -60,6 +72,9 @@ GridMap::GridMap()
     m_liquidFlags = NULL;
     m_liquidEntry = NULL;
     m_liquid_map  = NULL;
+
+    m_fileMapping = NULL;
+    m_copiedArrays = 0;
 }
 
 GridMap::~GridMap()
@@ -72,58 +87,90 @@ bool GridMap::loadData(char* filename)
     // Unload old data if exist
     unloadData();
 
-    GridMapFileHeader header;
     // Not return error if file not found
     FILE* in = fopen(filename, "rb");
     if (!in)
         return true;
+    fclose(in);
+
+    // shared read-only mapping: pages are loaded when first used and shared with other
+    // processes mapping the file, unloading the grid only has to unmap it
+    m_fileMapping = new ACE_Mem_Map();
+    if (m_fileMapping->map(ACE_TEXT_CHAR_TO_TCHAR(filename), static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_READ, ACE_MAP_SHARED) != 0)
+    {
+        sLog.outError("Error mapping map file '%s'", filename);
+        unloadData();
+        return false;
+    }
+
+    // the mapping stays valid without the file, don't keep a descriptor open for every loaded grid
+    m_fileMapping->close_handle();
+
+    uint8 const* data = static_cast<uint8 const*>(m_fileMapping->addr());
+    size_t fileSize = m_fileMapping->size();
+
+    GridMapFileHeader header;
+    if (fileSize >= sizeof(header))
+        memcpy(&header, data, sizeof(header));
 
-    fread(&header, sizeof(header), 1, in);
-    if (header.mapMagic     == *((uint32 const*)(MAP_MAGIC)) &&
+    if (fileSize >= sizeof(header) &&
+            header.mapMagic     == *((uint32 const*)(MAP_MAGIC)) &&
             header.versionMagic == *((uint32 const*)(MAP_VERSION_MAGIC)) &&
             IsAcceptableClientBuild(header.buildMagic))
     {
+        if (size_t(header.areaMapOffset) + header.areaMapSize > fileSize ||
+                size_t(header.heightMapOffset) + header.heightMapSize > fileSize ||
+                size_t(header.liquidMapOffset) + header.liquidMapSize > fileSize)
+        {
+            sLog.outError("Map file '%s' is truncated", filename);
+            unloadData();
+            return false;
+        }
+
         // loadup area data
-        if (header.areaMapOffset && !loadAreaData(in, header.areaMapOffset, header.areaMapSize))
+        if (header.areaMapOffset && !loadAreaData(data, header.areaMapOffset, header.areaMapSize))
         {
             sLog.outError("Error loading map area data\n");
-            fclose(in);
+            unloadData();
             return false;
         }
 
         // loadup height data
-        if (header.heightMapOffset && !loadHeightData(in, header.heightMapOffset, header.heightMapSize))
+        if (header.heightMapOffset && !loadHeightData(data, header.heightMapOffset, header.heightMapSize))
         {
             sLog.outError("Error loading map height data\n");
-            fclose(in);
+            unloadData();
             return false;
         }
 
         // loadup liquid data
-        if (header.liquidMapOffset && !loadGridMapLiquidData(in, header.liquidMapOffset, header.liquidMapSize))
+        if (header.liquidMapOffset && !loadGridMapLiquidData(data, header.liquidMapOffset, header.liquidMapSize))
         {
             sLog.outError("Error loading map liquids data\n");
-            fclose(in);
+            unloadData();
             return false;
         }
 
-        fclose(in);
         return true;
     }
 
     sLog.outError("Map file '%s' is non-compatible version (outdated?). Please, create new using ad.exe program.", filename);
-    fclose(in);
+    unloadData();
     return false;
 }
 
 void GridMap::unloadData()
 {
-    delete[] m_area_map;
-    delete[] m_V9;
-    delete[] m_V8;
-    delete[] m_liquidEntry;
-    delete[] m_liquidFlags;
-    delete[] m_liquid_map;
+    freeArray(m_area_map, GRID_MAP_ARRAY_AREA);
+    freeArray(m_V9, GRID_MAP_ARRAY_V9);
+    freeArray(m_V8, GRID_MAP_ARRAY_V8);
+    freeArray(m_liquidEntry, GRID_MAP_ARRAY_LIQUID_ENTRY);
+    freeArray(m_liquidFlags, GRID_MAP_ARRAY_LIQUID_FLAGS);
+    freeArray(m_liquid_map, GRID_MAP_ARRAY_LIQUID_MAP);
+
+    delete m_fileMapping;
+    m_fileMapping = NULL;
+    m_copiedArrays = 0;
 
     m_area_map = NULL;
     m_V9 = NULL;
@@ -134,59 +181,91 @@ void GridMap::unloadData()
     m_gridGetHeight = &GridMap::getHeightFromFlat;
 }
 
-bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
+// returns the array in place if it is aligned for T in the mapped file, else a copy
+template<class T>
+T const* GridMap::mapArray(uint8 const* data, uint32 offset, uint32 count, uint32 arrayFlag)
+{
+    uint8 const* src = data + offset;
+    if (reinterpret_cast<size_t>(src) % sizeof(T) == 0)
+        return reinterpret_cast<T const*>(src);
+
+    // allocated as bytes, freeArray() doesn't know the type
+    uint8* copy = new uint8[count * sizeof(T)];
+    memcpy(copy, src, count * sizeof(T));
+    m_copiedArrays |= arrayFlag;
+    return reinterpret_cast<T const*>(copy);
+}
+
+void GridMap::freeArray(void const* array, uint32 arrayFlag)
+{
+    if (m_copiedArrays & arrayFlag)
+        delete[] static_cast<uint8 const*>(array);
+}
+
+bool GridMap::loadAreaData(uint8 const* data, uint32 offset, uint32 size)
 {
     GridMapAreaHeader header;
-    fseek(in, offset, SEEK_SET);
-    fread(&header, sizeof(header), 1, in);
+    if (size < sizeof(header))
+        return false;
+
+    memcpy(&header, data + offset, sizeof(header));
     if (header.fourcc != *((uint32 const*)(MAP_AREA_MAGIC)))
         return false;
 
     m_gridArea = header.gridArea;
     if (!(header.flags & MAP_AREA_NO_AREA))
     {
-        m_area_map = new uint16 [16 * 16];
-        fread(m_area_map, sizeof(uint16), 16 * 16, in);
+        if (size < sizeof(header) + 16 * 16 * sizeof(uint16))
+            return false;
+
+        m_area_map = mapArray<uint16>(data, offset + sizeof(header), 16 * 16, GRID_MAP_ARRAY_AREA);
     }
 
     return true;
 }
 
-bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadHeightData(uint8 const* data, uint32 offset, uint32 size)
 {
     GridMapHeightHeader header;
-    fseek(in, offset, SEEK_SET);
-    fread(&header, sizeof(header), 1, in);
+    if (size < sizeof(header))
+        return false;
+
+    memcpy(&header, data + offset, sizeof(header));
     if (header.fourcc != *((uint32 const*)(MAP_HEIGHT_MAGIC)))
         return false;
 
+    uint32 V9Offset = offset + sizeof(header);
+
     m_gridHeight = header.gridHeight;
     if (!(header.flags & MAP_HEIGHT_NO_HEIGHT))
     {
         if ((header.flags & MAP_HEIGHT_AS_INT16))
         {
-            m_uint16_V9 = new uint16 [129 * 129];
-            m_uint16_V8 = new uint16 [128 * 128];
-            fread(m_uint16_V9, sizeof(uint16), 129 * 129, in);
-            fread(m_uint16_V8, sizeof(uint16), 128 * 128, in);
+            if (size < sizeof(header) + (129 * 129 + 128 * 128) * sizeof(uint16))
+                return false;
+
+            m_uint16_V9 = mapArray<uint16>(data, V9Offset, 129 * 129, GRID_MAP_ARRAY_V9);
+            m_uint16_V8 = mapArray<uint16>(data, V9Offset + 129 * 129 * sizeof(uint16), 128 * 128, GRID_MAP_ARRAY_V8);
             m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 65535;
             m_gridGetHeight = &GridMap::getHeightFromUint16;
         }
         else if ((header.flags & MAP_HEIGHT_AS_INT8))
         {
-            m_uint8_V9 = new uint8 [129 * 129];
-            m_uint8_V8 = new uint8 [128 * 128];
-            fread(m_uint8_V9, sizeof(uint8), 129 * 129, in);
-            fread(m_uint8_V8, sizeof(uint8), 128 * 128, in);
+            if (size < sizeof(header) + (129 * 129 + 128 * 128) * sizeof(uint8))
+                return false;
+
+            m_uint8_V9 = data + V9Offset;
+            m_uint8_V8 = data + V9Offset + 129 * 129 * sizeof(uint8);
             m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 255;
             m_gridGetHeight = &GridMap::getHeightFromUint8;
         }
         else
         {
-            m_V9 = new float [129 * 129];
-            m_V8 = new float [128 * 128];
-            fread(m_V9, sizeof(float), 129 * 129, in);
-            fread(m_V8, sizeof(float), 128 * 128, in);
+            if (size < sizeof(header) + (129 * 129 + 128 * 128) * sizeof(float))
+                return false;
+
+            m_V9 = mapArray<float>(data, V9Offset, 129 * 129, GRID_MAP_ARRAY_V9);
+            m_V8 = mapArray<float>(data, V9Offset + 129 * 129 * sizeof(float), 128 * 128, GRID_MAP_ARRAY_V8);
             m_gridGetHeight = &GridMap::getHeightFromFloat;
         }
     }
@@ -196,11 +275,13 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
     return true;
 }
 
-bool GridMap::loadGridMapLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadGridMapLiquidData(uint8 const* data, uint32 offset, uint32 size)
 {
     GridMapLiquidHeader header;
-    fseek(in, offset, SEEK_SET);
-    fread(&header, sizeof(header), 1, in);
+    if (size < sizeof(header))
+        return false;
+
+    memcpy(&header, data + offset, sizeof(header));
     if (header.fourcc != *((uint32 const*)(MAP_LIQUID_MAGIC)))
         return false;
 
@@ -211,19 +292,29 @@ bool GridMap::loadGridMapLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
     m_liquid_height = header.height;
     m_liquidLevel   = header.liquidLevel;
 
+    uint32 arrayOffset = offset + sizeof(header);
+    uint32 arraysSize = sizeof(header);
+
     if (!(header.flags & MAP_LIQUID_NO_TYPE))
     {
-        m_liquidEntry = new uint16[16 * 16];
-        fread(m_liquidEntry, sizeof(uint16), 16 * 16, in);
+        arraysSize += 16 * 16 * (sizeof(uint16) + sizeof(uint8));
+        if (size < arraysSize)
+            return false;
 
-        m_liquidFlags = new uint8[16 * 16];
-        fread(m_liquidFlags, sizeof(uint8), 16 * 16, in);
+        m_liquidEntry = mapArray<uint16>(data, arrayOffset, 16 * 16, GRID_MAP_ARRAY_LIQUID_ENTRY);
+        arrayOffset += 16 * 16 * sizeof(uint16);
+
+        m_liquidFlags = data + arrayOffset;
+        arrayOffset += 16 * 16 * sizeof(uint8);
     }
 
     if (!(header.flags & MAP_LIQUID_NO_HEIGHT))
     {
-        m_liquid_map = new float [m_liquid_width * m_liquid_height];
-        fread(m_liquid_map, sizeof(float), m_liquid_width * m_liquid_height, in);
+        arraysSize += m_liquid_width * m_liquid_height * sizeof(float);
+        if (size < arraysSize)
+            return false;
+
+        m_liquid_map = mapArray<float>(data, arrayOffset, m_liquid_width * m_liquid_height, GRID_MAP_ARRAY_LIQUID_MAP);
     }
 
     return true;
@@ -344,7 +435,7 @@ float GridMap::getHeightFromUint8(float x, float y) const
     y_int &= (MAP_RESOLUTION - 1);
 
     int32 a, b, c;
-    uint8* V9_h1_ptr = &m_uint8_V9[x_int * 128 + x_int + y_int];
+    uint8 const* V9_h1_ptr = &m_uint8_V9[x_int * 128 + x_int + y_int];
     if (x + y < 1)
     {
         if (x > y)
@@ -412,7 +503,7 @@ float GridMap::getHeightFromUint16(float x, float y) const
     y_int &= (MAP_RESOLUTION - 1);
 
     int32 a, b, c;
-    uint16* V9_h1_ptr = &m_uint16_V9[x_int * 128 + x_int + y_int];
+    uint16 const* V9_h1_ptr = &m_uint16_V9[x_int * 128 + x_int + y_int];
     if (x + y < 1)
     {
         if (x > y)
@@ -714,6 +805,15 @@ void TerrainInfo::Unload(const uint32 x, const uint32 y)
     }
 }
 
+void TerrainInfo::Preload(const uint32 x, const uint32 y)
+{
+    MANGOS_ASSERT(x < MAX_NUMBER_OF_GRIDS);
+    MANGOS_ASSERT(y < MAX_NUMBER_OF_GRIDS);
+
+    if (!m_GridMaps[x][y])
+        sTerrainMgr.GetPreloader().Request(m_mapId, x, y);
+}
+
 // call this method only
 void TerrainInfo::CleanUpGrids(const uint32 diff)
 {
@@ -1118,21 +1218,32 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
 
         if (!m_GridMaps[x][y])
         {
-            GridMap* map = new GridMap();
+            uint32 startTime = WorldTimer::getMSTime();
 
-            // map file name
-            int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
-            char* tmp = new char[len];
-            snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), m_mapId, x, y);
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Loading map %s", tmp);
+            // use the data read ahead in background if the grid was expected
+            PreloadedGrid preloaded;
+            bool isPreloaded = sTerrainMgr.GetPreloader().Take(m_mapId, x, y, preloaded);
 
-            if (!map->loadData(tmp))
+            GridMap* map = preloaded.gridMap;
+            if (!isPreloaded)
             {
-                sLog.outError("Error load map file: \n %s\n", tmp);
-                // ASSERT(false);
+                map = new GridMap();
+
+                // map file name
+                int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
+                char* tmp = new char[len];
+                snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), m_mapId, x, y);
+                DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Loading map %s", tmp);
+
+                if (!map->loadData(tmp))
+                {
+                    sLog.outError("Error load map file: \n %s\n", tmp);
+                    // ASSERT(false);
+                }
+
+                delete[] tmp;
             }
 
-            delete[] tmp;
             m_GridMaps[x][y] = map;
 
             // load VMAPs for current map/grid...
@@ -1154,7 +1265,10 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
             }
 
             // load navmesh
-            MMAP::MMapFactory::createOrGetMMapManager()->loadMap(m_mapId, x, y);
+            MMAP::MMapFactory::createOrGetMMapManager()->loadMap(m_mapId, x, y, preloaded.navMeshData, preloaded.navMeshDataSize);
+
+            if (!isPreloaded)
+                sTerrainMgr.GetPreloader().AddBlockedLoad(WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime()));
         }
     }
 
@@ -1240,10 +1354,14 @@ void TerrainManager::Update(const uint32 diff)
     // global garbage collection for GridMap objects and VMaps
     for (TerrainDataMap::iterator iter = i_TerrainMap.begin(); iter != i_TerrainMap.end(); ++iter)
         iter->second->CleanUpGrids(diff);
+
+    m_preloader.Update();
 }
 
 void TerrainManager::UnloadAll()
 {
+    m_preloader.Deactivate();
+
     for (TerrainDataMap::iterator it = i_TerrainMap.begin(); it != i_TerrainMap.end(); ++it)
         delete it->second;
 
@@ -25,6 +25,7 @@
 #include "GridDefines.h"
 #include "Object.h"
 #include "SharedDefines.h"
+#include "GridPreloader.h"
 
 #include <bitset>
 #include <list>
@@ -36,6 +37,7 @@ class InstanceData;
 class Group;
 class BattleGround;
 class Map;
+class ACE_Mem_Map;
 
 struct GridMapFileHeader
 {
@@ -125,22 +127,22 @@ class GridMap
 
         // Area data
         uint16 m_gridArea;
-        uint16* m_area_map;
+        uint16 const* m_area_map;
 
         // Height level data
         float m_gridHeight;
         float m_gridIntHeightMultiplier;
         union
         {
-            float* m_V9;
-            uint16* m_uint16_V9;
-            uint8* m_uint8_V9;
+            float const* m_V9;
+            uint16 const* m_uint16_V9;
+            uint8 const* m_uint8_V9;
         };
         union
         {
-            float* m_V8;
-            uint16* m_uint16_V8;
-            uint8* m_uint8_V8;
+            float const* m_V8;
+            uint16 const* m_uint16_V8;
+            uint8 const* m_uint8_V8;
         };
 
         // Liquid data
@@ -150,13 +152,21 @@ class GridMap
         uint8 m_liquid_width;
         uint8 m_liquid_height;
         float m_liquidLevel;
-        uint16* m_liquidEntry;
-        uint8* m_liquidFlags;
-        float* m_liquid_map;
+        uint16 const* m_liquidEntry;
+        uint8 const* m_liquidFlags;
+        float const* m_liquid_map;
 
-        bool loadAreaData(FILE* in, uint32 offset, uint32 size);
-        bool loadHeightData(FILE* in, uint32 offset, uint32 size);
-        bool loadGridMapLiquidData(FILE* in, uint32 offset, uint32 size);
+        // the arrays above point into the read-only mapped file, shared with all processes using it
+        ACE_Mem_Map* m_fileMapping;
+        uint32 m_copiedArrays;                              ///< GridMapArray flags of arrays not aligned in the file, these are copies
+
+        bool loadAreaData(uint8 const* data, uint32 offset, uint32 size);
+        bool loadHeightData(uint8 const* data, uint32 offset, uint32 size);
+        bool loadGridMapLiquidData(uint8 const* data, uint32 offset, uint32 size);
+
+        template<class T>
+        T const* mapArray(uint8 const* data, uint32 offset, uint32 count, uint32 arrayFlag);
+        void freeArray(void const* array, uint32 arrayFlag);
 
         // Get height functions and pointers
         typedef float(GridMap::*pGetHeightPtr)(float x, float y) const;
@@ -251,6 +261,8 @@ class MANGOS_DLL_SPEC TerrainInfo : public Referencable<AtomicLong>
         // load/unload terrain data
         GridMap* Load(const uint32 x, const uint32 y);
         void Unload(const uint32 x, const uint32 y);
+        // queue terrain data of a grid expected to be entered soon for background loading
+        void Preload(const uint32 x, const uint32 y);
 
     private:
         TerrainInfo(const TerrainInfo&);
@@ -289,6 +301,8 @@ class MANGOS_DLL_DECL TerrainManager : public MaNGOS::Singleton<TerrainManager,
         void Update(const uint32 diff);
         void UnloadAll();
 
+        GridPreloader& GetPreloader() { return m_preloader; }
+
         uint16 GetAreaFlag(uint32 mapid, float x, float y, float z) const
         {
             TerrainInfo* pData = const_cast<TerrainManager*>(this)->LoadTerrain(mapid);
@@ -320,6 +334,7 @@ class MANGOS_DLL_DECL TerrainManager : public MaNGOS::Singleton<TerrainManager,
 
         typedef MaNGOS::ClassLevelLockable<TerrainManager, ACE_Thread_Mutex>::Lock Guard;
         TerrainDataMap i_TerrainMap;
+        GridPreloader m_preloader;
 };
 
 #define sTerrainMgr TerrainManager::Instance()
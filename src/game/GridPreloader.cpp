@@ -0,0 +1,300 @@
+/**
+ * This code is part of MaNGOS. Contributor & Copyright details are in AUTHORS/THANKS.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "GridPreloader.h"
+#include "GridMap.h"
+#include "MoveMap.h"
+#include "VMapFactory.h"
+#include "VMapDefinitions.h"
+#include "MapTree.h"
+#include "ModelInstance.h"
+#include "World.h"
+#include "Timer.h"
+#include "Log.h"
+
+// preloaded grids not taken within this time were not entered after all
+#define GRID_PRELOAD_EXPIRE_TIME    (60 * IN_MILLISECONDS)
+// more queued grids than this are outdated, drop the oldest
+#define GRID_PRELOAD_MAX_QUEUED     64
+
+class GridPreloadWorker : public ACE_Based::Runnable
+{
+    public:
+        explicit GridPreloadWorker(GridPreloader& preloader) : m_preloader(preloader) {}
+
+        void run() override { m_preloader.WorkerLoop(); }
+
+    private:
+        GridPreloader& m_preloader;
+};
+
+// read a whole file so it is in the file cache when it is really used
+static void ReadAheadFile(std::string const& fileName)
+{
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (!file)
+        return;
+
+    char buffer[64 * 1024];
+    while (fread(buffer, 1, sizeof(buffer), file) == sizeof(buffer)) {}
+
+    fclose(file);
+}
+
+GridPreloader::GridPreloader() :
+    m_thread(NULL), m_workCondition(m_lock), m_readyCondition(m_lock), m_running(false)
+{
+}
+
+GridPreloader::~GridPreloader()
+{
+    Deactivate();
+}
+
+void GridPreloader::Activate()
+{
+    if (IsActivated())
+        return;
+
+    m_running = true;
+    m_thread = new ACE_Based::Thread(new GridPreloadWorker(*this));
+
+    sLog.outString("Grid terrain data will be preloaded ahead of moving players");
+}
+
+void GridPreloader::Deactivate()
+{
+    if (!IsActivated())
+        return;
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+        m_running = false;
+        m_workCondition.broadcast();
+        m_readyCondition.broadcast();
+    }
+
+    m_thread->wait();
+    delete m_thread;
+    m_thread = NULL;
+
+    for (PreloadEntryMap::iterator itr = m_entries.begin(); itr != m_entries.end(); ++itr)
+        FreeGrid(itr->second.grid);
+
+    m_entries.clear();
+    m_queue.clear();
+}
+
+void GridPreloader::Request(uint32 mapId, uint32 x, uint32 y)
+{
+    if (!IsActivated())
+        return;
+
+    uint32 key = MakeKey(mapId, x, y);
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    if (m_entries.find(key) != m_entries.end())
+        return;
+
+    if (m_queue.size() >= GRID_PRELOAD_MAX_QUEUED)
+    {
+        m_entries.erase(m_queue.front());
+        m_queue.pop_front();
+    }
+
+    m_entries[key] = PreloadEntry();
+    m_queue.push_back(key);
+    ++m_stats.requests;
+
+    m_workCondition.signal();
+}
+
+bool GridPreloader::Take(uint32 mapId, uint32 x, uint32 y, PreloadedGrid& grid)
+{
+    if (!IsActivated())
+        return false;
+
+    uint32 key = MakeKey(mapId, x, y);
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, false);
+
+    PreloadEntryMap::iterator itr = m_entries.find(key);
+    if (itr == m_entries.end())
+        return false;
+
+    if (itr->second.state == PRELOAD_QUEUED)
+    {
+        // not started yet, the caller loads it faster than waiting for the queue ahead
+        m_queue.erase(std::find(m_queue.begin(), m_queue.end(), key));
+        m_entries.erase(itr);
+        return false;
+    }
+
+    // half done already, waiting is cheaper than reading the files again
+    while (m_running && itr != m_entries.end() && itr->second.state == PRELOAD_LOADING)
+    {
+        m_readyCondition.wait();
+        itr = m_entries.find(key);
+    }
+
+    if (itr == m_entries.end() || itr->second.state != PRELOAD_READY)
+        return false;
+
+    grid = itr->second.grid;
+    m_entries.erase(itr);
+    ++m_stats.used;
+    return true;
+}
+
+void GridPreloader::AddBlockedLoad(uint32 time)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    ++m_stats.blockedLoads;
+    m_stats.blockedTime += time;
+}
+
+void GridPreloader::Update()
+{
+    if (!IsActivated())
+        return;
+
+    uint32 now = WorldTimer::getMSTime();
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    for (PreloadEntryMap::iterator itr = m_entries.begin(); itr != m_entries.end();)
+    {
+        if (itr->second.state == PRELOAD_READY && WorldTimer::getMSTimeDiff(itr->second.readyTime, now) > GRID_PRELOAD_EXPIRE_TIME)
+        {
+            FreeGrid(itr->second.grid);
+            m_entries.erase(itr++);
+            ++m_stats.expired;
+        }
+        else
+            ++itr;
+    }
+}
+
+GridPreloadStats GridPreloader::GetStats(bool reset)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, GridPreloadStats());
+
+    GridPreloadStats stats = m_stats;
+    if (reset)
+        m_stats = GridPreloadStats();
+
+    return stats;
+}
+
+void GridPreloader::WorkerLoop()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    while (true)
+    {
+        while (m_running && m_queue.empty())
+            m_workCondition.wait();
+
+        if (!m_running)
+            return;
+
+        uint32 key = m_queue.front();
+        m_queue.pop_front();
+        m_entries[key].state = PRELOAD_LOADING;
+
+        PreloadedGrid grid;
+
+        m_lock.release();
+        LoadGrid(key >> 16, (key >> 8) & 0xFF, key & 0xFF, grid);
+        m_lock.acquire();
+
+        PreloadEntry& entry = m_entries[key];
+        entry.state = PRELOAD_READY;
+        entry.grid = grid;
+        entry.readyTime = WorldTimer::getMSTime();
+
+        m_readyCondition.broadcast();
+    }
+}
+
+void GridPreloader::LoadGrid(uint32 mapId, uint32 x, uint32 y, PreloadedGrid& grid)
+{
+    DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Preloading terrain of map %u grid [%u,%u]", mapId, x, y);
+
+    // map file name
+    int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
+    char* tmp = new char[len];
+    snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), mapId, x, y);
+
+    // the grid map only maps the file, bring its pages into the file cache here
+    ReadAheadFile(tmp);
+
+    grid.gridMap = new GridMap();
+    if (!grid.gridMap->loadData(tmp))
+        sLog.outError("Error load map file: \n %s\n", tmp);
+
+    delete[] tmp;
+
+    VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+    if (vmgr->isHeightCalcEnabled() || vmgr->isLineOfSightCalcEnabled())
+        ReadAheadVMapTile(mapId, x, y);
+
+    if (MMAP::MMapFactory::IsPathfindingEnabled(mapId))
+        grid.navMeshData = MMAP::MMapManager::readTileData(mapId, x, y, grid.navMeshDataSize);
+}
+
+void GridPreloader::ReadAheadVMapTile(uint32 mapId, uint32 x, uint32 y)
+{
+    // vmap tiles reference model instances shared by the vmap manager, only the files can be prepared
+    std::string basePath = sWorld.GetDataPath() + "vmaps/";
+
+    FILE* tf = fopen((basePath + VMAP::StaticMapTree::getTileFileName(mapId, x, y)).c_str(), "rb");
+    if (!tf)
+        return;
+
+    char chunk[8];
+    uint32 numSpawns;
+    if (VMAP::readChunk(tf, chunk, VMAP::VMAP_MAGIC, 8) && fread(&numSpawns, sizeof(uint32), 1, tf) == 1)
+    {
+        for (uint32 i = 0; i < numSpawns; ++i)
+        {
+            VMAP::ModelSpawn spawn;
+            uint32 referencedVal;
+            if (!VMAP::ModelSpawn::readFromFile(tf, spawn) || fread(&referencedVal, sizeof(uint32), 1, tf) != 1)
+                break;
+
+            ReadAheadFile(basePath + spawn.name + ".vmo");
+        }
+    }
+
+    fclose(tf);
+}
+
+void GridPreloader::FreeGrid(PreloadedGrid& grid)
+{
+    if (grid.gridMap)
+    {
+        grid.gridMap->unloadData();
+        delete grid.gridMap;
+    }
+
+    dtFree(grid.navMeshData);
+    grid = PreloadedGrid();
+}
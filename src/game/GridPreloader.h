@@ -0,0 +1,127 @@
+/**
+ * This code is part of MaNGOS. Contributor & Copyright details are in AUTHORS/THANKS.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_GRIDPRELOADER_H
+#define MANGOS_GRIDPRELOADER_H
+
+#include "Common.h"
+#include "Threading.h"
+#include "ace/Thread_Mutex.h"
+#include "ace/Condition_Thread_Mutex.h"
+
+#include <deque>
+
+class GridMap;
+
+// terrain data of one grid read ahead by the preloader, not yet attached to a TerrainInfo
+struct PreloadedGrid
+{
+    PreloadedGrid() : gridMap(NULL), navMeshData(NULL), navMeshDataSize(0) {}
+
+    GridMap* gridMap;
+    unsigned char* navMeshData;                             ///< dtAlloc'ed mmtile, NULL if the map has no navmesh tile here
+    uint32 navMeshDataSize;
+};
+
+struct GridPreloadStats
+{
+    GridPreloadStats() : requests(0), used(0), expired(0), blockedLoads(0), blockedTime(0) {}
+
+    uint32 requests;                                        ///< grids queued for preloading
+    uint32 used;                                            ///< grids attached from preloaded data
+    uint32 expired;                                         ///< preloaded grids dropped without being used
+    uint32 blockedLoads;                                    ///< grids loaded from disk by the thread that needed them
+    uint32 blockedTime;                                     ///< time spent in those loads
+};
+
+/**
+ * Background thread loading terrain data of grids that are expected to be entered soon.
+ *
+ * Maps queue the grids ahead of moving players with Request(). The thread maps the .map file
+ * and reads the navmesh tile, which do not touch any shared state, and reads the .map file, the
+ * vmap tile and its models ahead so the file cache has them. TerrainInfo takes the prepared
+ * data with Take() when the grid is really loaded and attaches it there, in the thread of the
+ * map as before.
+ */
+class GridPreloader
+{
+    public:
+        GridPreloader();
+        ~GridPreloader();
+
+        void Activate();
+        void Deactivate();
+        bool IsActivated() const { return m_thread != NULL; }
+
+        // queue a grid for preloading, x and y are terrain grid coordinates, ignored if not activated
+        void Request(uint32 mapId, uint32 x, uint32 y);
+
+        // hand over the preloaded data of a grid, waits if it is being loaded right now
+        bool Take(uint32 mapId, uint32 x, uint32 y, PreloadedGrid& grid);
+
+        // account a grid that had to be loaded from disk by the thread needing it
+        void AddBlockedLoad(uint32 time);
+
+        // drop preloaded grids not taken in time, called from the world thread
+        void Update();
+
+        GridPreloadStats GetStats(bool reset);
+
+    private:
+        friend class GridPreloadWorker;
+
+        enum PreloadState
+        {
+            PRELOAD_QUEUED,
+            PRELOAD_LOADING,
+            PRELOAD_READY
+        };
+
+        struct PreloadEntry
+        {
+            PreloadEntry() : state(PRELOAD_QUEUED), readyTime(0) {}
+
+            PreloadState state;
+            PreloadedGrid grid;
+            uint32 readyTime;
+        };
+
+        static uint32 MakeKey(uint32 mapId, uint32 x, uint32 y) { return (mapId << 16) | (x << 8) | y; }
+
+        // worker thread body, returns when the preloader is deactivated
+        void WorkerLoop();
+
+        static void LoadGrid(uint32 mapId, uint32 x, uint32 y, PreloadedGrid& grid);
+        static void ReadAheadVMapTile(uint32 mapId, uint32 x, uint32 y);
+        static void FreeGrid(PreloadedGrid& grid);
+
+        ACE_Based::Thread* m_thread;
+
+        ACE_Thread_Mutex m_lock;
+        ACE_Condition_Thread_Mutex m_workCondition;         ///< signaled when a grid was queued or at shutdown
+        ACE_Condition_Thread_Mutex m_readyCondition;        ///< signaled when the worker finished a grid
+
+        typedef UNORDERED_MAP<uint32, PreloadEntry> PreloadEntryMap;
+        PreloadEntryMap m_entries;
+        std::deque<uint32> m_queue;                         ///< keys of queued entries, oldest first
+        bool m_running;
+
+        GridPreloadStats m_stats;
+};
+
+#endif
@@ -24,6 +24,7 @@
 #include "Policies/Singleton.h"
 #include "ProgressBar.h"
 #include "World.h"
+#include "MapUpdater.h"
 
 INSTANTIATE_SINGLETON_1(GuildMgr);
 
@@ -39,11 +40,15 @@ GuildMgr::~GuildMgr()
 
 void GuildMgr::AddGuild(Guild* guild)
 {
+    MANGOS_ASSERT_NOT_MAP_WORKER();
+
     m_GuildMap[guild->GetId()] = guild;
 }
 
 void GuildMgr::RemoveGuild(uint32 guildId)
 {
+    MANGOS_ASSERT_NOT_MAP_WORKER();
+
     m_GuildMap.erase(guildId);
 }
 
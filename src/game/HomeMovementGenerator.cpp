@@ -21,6 +21,7 @@
 #include "CreatureAI.h"
 #include "ObjectMgr.h"
 #include "WorldPacket.h"
+#include "PathFinder.h"
 #include "movement/MoveSplineInit.h"
 #include "movement/MoveSpline.h"
 
@@ -38,31 +39,55 @@ void HomeMovementGenerator<Creature>::_setTargetLocation(Creature& owner)
     if (owner.hasUnitState(UNIT_STAT_NOT_MOVE))
         return;
 
-    Movement::MoveSplineInit init(owner);
-    float x, y, z, o;
+    float x, y, z;
     // at apply we can select more nice return points base at current movegen
+    useFacing = false;
     if (owner.GetMotionMaster()->empty() || !owner.GetMotionMaster()->top()->GetResetPosition(owner, x, y, z))
     {
-        owner.GetRespawnCoord(x, y, z, &o);
-        init.SetFacing(o);
+        owner.GetRespawnCoord(x, y, z, &facing);
+        useFacing = true;
     }
 
-    init.MoveTo(x, y, z, true);
-    init.SetWalk(false);
-    init.Launch();
+    // with path threads the creature starts moving in Update() once the path is calculated
+    PathFinder* path = new PathFinder(&owner);
+    if (!pathRequest.Request(path, x, y, z))
+    {
+        path->calculate(x, y, z);
+        _moveByPath(owner, *path);
+        delete path;
+    }
 
     arrived = false;
     owner.clearUnitState(UNIT_STAT_ALL_DYN_STATES);
 }
 
+void HomeMovementGenerator<Creature>::_moveByPath(Creature& owner, PathFinder& path)
+{
+    Movement::MoveSplineInit init(owner);
+    init.MovebyPath(path.getPath());
+    if (useFacing)
+        init.SetFacing(facing);
+    init.SetWalk(false);
+    init.Launch();
+}
+
 bool HomeMovementGenerator<Creature>::Update(Creature& owner, const uint32& time_diff)
 {
-    arrived = owner.movespline->Finalized();
+    if (PathFinder* path = pathRequest.TakeResult(owner))
+    {
+        _moveByPath(owner, *path);
+        delete path;
+    }
+
+    // not home before the path was even calculated
+    arrived = !pathRequest.IsPending() && owner.movespline->Finalized();
     return !arrived;
 }
 
 void HomeMovementGenerator<Creature>::Finalize(Creature& owner)
 {
+    pathRequest.Cancel();
+
     if (arrived)
     {
         if (owner.GetTemporaryFactionFlags() & TEMPFACTION_RESTORE_REACH_HOME)
@@ -20,6 +20,7 @@
 #define MANGOS_HOMEMOVEMENTGENERATOR_H
 
 #include "MovementGenerator.h"
+#include "PathRequestService.h"
 
 class Creature;
 
@@ -32,18 +33,23 @@ class MANGOS_DLL_SPEC HomeMovementGenerator<Creature>
 {
     public:
 
-        HomeMovementGenerator() : arrived(false) {}
+        HomeMovementGenerator() : arrived(false), useFacing(false), facing(0.0f) {}
         ~HomeMovementGenerator() {}
 
         void Initialize(Creature&);
         void Finalize(Creature&);
-        void Interrupt(Creature&) {}
+        void Interrupt(Creature&) { pathRequest.Cancel(); }
         void Reset(Creature&);
         bool Update(Creature&, const uint32&);
         MovementGeneratorType GetMovementGeneratorType() const override { return HOME_MOTION_TYPE; }
 
     private:
         void _setTargetLocation(Creature&);
+        void _moveByPath(Creature&, PathFinder&);
+
         bool arrived;
+        bool useFacing;                                     // respawn orientation taken at arrival
+        float facing;
+        PathRequestHandle pathRequest;
 };
 #endif
@@ -291,11 +291,13 @@ void WorldSession::HandleItemQuerySingleOpcode(WorldPacket& recv_data)
     {
         int loc_idx = GetSessionDbLocaleIndex();
 
+        if (sObjectMgr.GetQueryResponseCache().Send(this, QUERY_RESPONSE_ITEM, item, loc_idx))
+            return;
+
         std::string name = pProto->Name1;
         std::string description = pProto->Description;
         sObjectMgr.GetItemLocaleStrings(pProto->ItemId, loc_idx, &name, &description);
 
-
         // guess size
         WorldPacket data(SMSG_ITEM_QUERY_SINGLE_RESPONSE, 600);
         data << pProto->ItemId;
@@ -421,6 +423,8 @@ void WorldSession::HandleItemQuerySingleOpcode(WorldPacket& recv_data)
         data << uint32(pProto->Duration);                   // added in 2.4.2.8209, duration (seconds)
         data << uint32(pProto->ItemLimitCategory);          // WotLK, ItemLimitCategory
         data << uint32(pProto->HolidayId);                  // Holiday.dbc?
+
+        sObjectMgr.GetQueryResponseCache().Store(QUERY_RESPONSE_ITEM, item, loc_idx, data);
         SendPacket(&data);
     }
     else
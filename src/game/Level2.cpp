@@ -2611,6 +2611,28 @@ bool ChatHandler::HandlePInfoCommand(char* args)
     uint32 copp = (money % GOLD) % SILVER;
     PSendSysMessage(LANG_PINFO_LEVEL,  timeStr.c_str(), level, gold, silv, copp);
 
+    if (target)
+    {
+        SessionPacketStats stats = target->GetSession()->GetPacketStats();
+        PSendSysMessage("Packets: %u handled, peak queue %u, average wait %u ms, longest %u ms (%s)",
+                        stats.processed, stats.peakQueueSize, stats.processed ? uint32(stats.totalWaitTime / stats.processed) : 0,
+                        stats.maxWaitTime, LookupOpcodeName(stats.maxWaitOpcode));
+
+        // opcodes that waited the most in total
+        std::vector<std::pair<uint64, uint16> > opcodes;
+        for (OpcodeWaitStatsMap::const_iterator itr = stats.opcodes.begin(); itr != stats.opcodes.end(); ++itr)
+            opcodes.push_back(std::pair<uint64, uint16>(itr->second.totalWaitTime, itr->first));
+
+        std::sort(opcodes.begin(), opcodes.end(), std::greater<std::pair<uint64, uint16> >());
+
+        for (uint32 i = 0; i < opcodes.size() && i < 5 && opcodes[i].first; ++i)
+        {
+            OpcodeWaitStats const& opcodeStats = stats.opcodes[opcodes[i].second];
+            PSendSysMessage("    %s: %u packets, average wait %u ms, longest %u ms", LookupOpcodeName(opcodes[i].second),
+                            opcodeStats.processed, uint32(opcodeStats.totalWaitTime / opcodeStats.processed), opcodeStats.maxWaitTime);
+        }
+    }
+
     return true;
 }
 
@@ -5387,7 +5409,7 @@ bool ChatHandler::HandleMmapLocCommand(char* /*args*/)
 
     // calculate navmesh tile location
     const dtNavMesh* navmesh = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMesh(player->GetMapId());
-    const dtNavMeshQuery* navmeshquery = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQuery(player->GetMapId(), player->GetInstanceId());
+    const dtNavMeshQuery* navmeshquery = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQuery(player->GetMapId());
     if (!navmesh || !navmeshquery)
     {
         PSendSysMessage("NavMesh not loaded for current map.");
@@ -5432,7 +5454,7 @@ bool ChatHandler::HandleMmapLoadedTilesCommand(char* /*args*/)
     uint32 mapid = m_session->GetPlayer()->GetMapId();
 
     const dtNavMesh* navmesh = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMesh(mapid);
-    const dtNavMeshQuery* navmeshquery = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQuery(mapid, m_session->GetPlayer()->GetInstanceId());
+    const dtNavMeshQuery* navmeshquery = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQuery(mapid);
     if (!navmesh || !navmeshquery)
     {
         PSendSysMessage("NavMesh not loaded for current map.");
@@ -5461,6 +5483,10 @@ bool ChatHandler::HandleMmapStatsCommand(char* /*args*/)
     MMAP::MMapManager* manager = MMAP::MMapFactory::createOrGetMMapManager();
     PSendSysMessage(" %u maps loaded with %u tiles overall", manager->getLoadedMapsCount(), manager->getLoadedTilesCount());
 
+    MMAP::NavMeshQueryStats queryStats = manager->GetQueryStats(false);
+    PSendSysMessage(" %u path searches, %u ran out of search nodes", queryStats.pathSearches, queryStats.nodeExhaustions);
+    PSendSysMessage(" %u navmesh queries allocated, %u reused for another map", queryStats.queriesCreated, queryStats.queriesEvicted);
+
     const dtNavMesh* navmesh = manager->GetNavMesh(m_session->GetPlayer()->GetMapId());
     if (!navmesh)
     {
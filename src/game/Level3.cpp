@@ -57,6 +57,7 @@
 #include "DBCEnums.h"
 #include "AuctionHouseBot/AuctionHouseBot.h"
 #include "SQLStorages.h"
+#include "OpcodeProfiler.h"
 
 static uint32 ahbotQualityIds[MAX_AUCTION_QUALITY] =
 {
@@ -4423,6 +4424,13 @@ void ChatHandler::HandleCharacterLevel(Player* player, ObjectGuid player_guid, u
     {
         // update level and XP at level, all other will be updated at loading
         CharacterDatabase.PExecute("UPDATE characters SET level = '%u', xp = 0 WHERE guid = '%u'", newlevel, player_guid.GetCounter());
+
+        CharacterNameData nameData;
+        if (sObjectMgr.GetCharacterNameData(player_guid.GetCounter(), nameData))
+        {
+            nameData.level = uint8(newlevel);
+            sObjectMgr.SetCharacterNameData(player_guid.GetCounter(), nameData);
+        }
     }
 }
 
@@ -6256,6 +6264,75 @@ bool ChatHandler::HandleServerPLimitCommand(char* args)
     return true;
 }
 
+bool ChatHandler::HandleServerOpcodesCommand(char* args)
+{
+    if (*args)
+    {
+        bool value;
+        if (!ExtractOnOff(&args, value))
+        {
+            SendSysMessage(LANG_USE_BOL);
+            SetSentErrorMessage(true);
+            return false;
+        }
+
+        if (value)
+            sOpcodeProfiler.Start();
+        else
+            sOpcodeProfiler.Stop();
+    }
+
+    PSendSysMessage("Opcode profiling is %s, data of %u seconds collected.", GetOnOffStr(sOpcodeProfiler.IsActive()), sOpcodeProfiler.GetDuration());
+
+    // handlers that took the most time
+    OpcodeProfileList profiles = sOpcodeProfiler.GetProfiles();
+    for (uint32 i = 0; i < profiles.size() && i < 10; ++i)
+    {
+        OpcodeProfile const& profile = profiles[i];
+        PSendSysMessage("%s: %u packets, total %u ms, average %u us, max %u us",
+                        LookupOpcodeName(profile.opcode), profile.count, uint32(profile.totalTime / 1000),
+                        uint32(profile.totalTime / profile.count), profile.maxTime);
+    }
+
+    return true;
+}
+
+bool ChatHandler::HandleServerOpcodesDumpCommand(char* args)
+{
+    std::string fileName = sLog.GetLogsDir();
+    if (char* file = ExtractQuotedOrLiteralArg(&args))
+    {
+        // only files in the logs directory can be written
+        if (strpbrk(file, "/\\") || strstr(file, ".."))
+        {
+            PSendSysMessage("Invalid file name %s, it can't contain a path.", file);
+            SetSentErrorMessage(true);
+            return false;
+        }
+
+        fileName += file;
+    }
+    else
+        fileName += "opcodes_" + Log::GetTimestampStr() + ".csv";
+
+    if (!sOpcodeProfiler.Dump(fileName))
+    {
+        PSendSysMessage(LANG_FILE_OPEN_FAIL, fileName.c_str());
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    PSendSysMessage("Opcode profile written to %s.", fileName.c_str());
+    return true;
+}
+
+bool ChatHandler::HandleServerOpcodesResetCommand(char* /*args*/)
+{
+    sOpcodeProfiler.Reset();
+    SendSysMessage("Opcode profile cleared.");
+    return true;
+}
+
 bool ChatHandler::HandleCastCommand(char* args)
 {
     if (!*args)
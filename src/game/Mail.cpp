@@ -157,7 +157,12 @@ void MailDraft::deleteIncludedItems(bool inDB /**= false*/)
         Item* item = mailItemIter->second;
 
         if (inDB)
-            CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid='%u'", item->GetGUIDLow());
+        {
+            static SqlStatementID delItem ;
+
+            SqlStatement stmt = CharacterDatabase.CreateStatement(delItem, "DELETE FROM item_instance WHERE guid = ?");
+            stmt.PExecute(item->GetGUIDLow());
+        }
 
         delete item;
     }
@@ -226,7 +231,10 @@ void MailDraft::SendReturnToSender(uint32 sender_acc, ObjectGuid sender_guid, Ob
             Item* item = mailItemIter->second;
             item->SaveToDB();                               // item not in inventory and can be save standalone
             // owner in data will set at mail receive and item extracting
-            CharacterDatabase.PExecute("UPDATE item_instance SET owner_guid = '%u' WHERE guid='%u'", receiver_guid.GetCounter(), item->GetGUIDLow());
+            static SqlStatementID updItemOwner ;
+
+            SqlStatement stmt = CharacterDatabase.CreateStatement(updItemOwner, "UPDATE item_instance SET owner_guid = ? WHERE guid = ?");
+            stmt.PExecute(receiver_guid.GetCounter(), item->GetGUIDLow());
         }
         CharacterDatabase.CommitTransaction();
     }
@@ -282,23 +290,34 @@ void MailDraft::SendMailTo(MailReceiver const& receiver, MailSender const& sende
 
     time_t expire_time = deliver_time + expire_delay;
 
-    // Add to DB
-    std::string safe_subject = GetSubject();
-    CharacterDatabase.escape_string(safe_subject);
-
-    std::string safe_body = GetBody();
-    CharacterDatabase.escape_string(safe_body);
+    // Add to DB, subject and body are sent as statement parameters and need no escaping
+    static SqlStatementID insMail ;
+    static SqlStatementID insMailItem ;
 
     CharacterDatabase.BeginTransaction();
-    CharacterDatabase.PExecute("INSERT INTO mail (id,messageType,stationery,mailTemplateId,sender,receiver,subject,body,has_items,expire_time,deliver_time,money,cod,checked) "
-                               "VALUES ('%u', '%u', '%u', '%u', '%u', '%u', '%s', '%s', '%u', '" UI64FMTD "','" UI64FMTD "', '%u', '%u', '%u')",
-                               mailId, sender.GetMailMessageType(), sender.GetStationery(), GetMailTemplateId(), sender.GetSenderId(), receiver.GetPlayerGuid().GetCounter(), safe_subject.c_str(), safe_body.c_str(), (has_items ? 1 : 0), (uint64)expire_time, (uint64)deliver_time, m_money, m_COD, checked);
-
+    SqlStatement stmt = CharacterDatabase.CreateStatement(insMail, "INSERT INTO mail (id,messageType,stationery,mailTemplateId,sender,receiver,subject,body,has_items,expire_time,deliver_time,money,cod,checked) "
+                        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    stmt.addUInt32(mailId);
+    stmt.addUInt8(sender.GetMailMessageType());
+    stmt.addUInt32(sender.GetStationery());
+    stmt.addUInt32(GetMailTemplateId());
+    stmt.addUInt32(sender.GetSenderId());
+    stmt.addUInt32(receiver.GetPlayerGuid().GetCounter());
+    stmt.addString(GetSubject());
+    stmt.addString(GetBody());
+    stmt.addUInt8(has_items ? 1 : 0);
+    stmt.addUInt64(uint64(expire_time));
+    stmt.addUInt64(uint64(deliver_time));
+    stmt.addUInt32(m_money);
+    stmt.addUInt32(m_COD);
+    stmt.addUInt32(checked);
+    stmt.Execute();
+
+    stmt = CharacterDatabase.CreateStatement(insMailItem, "INSERT INTO mail_items (mail_id,item_guid,item_template,receiver) VALUES (?, ?, ?, ?)");
     for (MailItemMap::const_iterator mailItemIter = m_items.begin(); mailItemIter != m_items.end(); ++mailItemIter)
     {
         Item* item = mailItemIter->second;
-        CharacterDatabase.PExecute("INSERT INTO mail_items (mail_id,item_guid,item_template,receiver) VALUES ('%u', '%u', '%u','%u')",
-                                   mailId, item->GetGUIDLow(), item->GetEntry(), receiver.GetPlayerGuid().GetCounter());
+        stmt.PExecute(mailId, item->GetGUIDLow(), item->GetEntry(), receiver.GetPlayerGuid().GetCounter());
     }
     CharacterDatabase.CommitTransaction();
 
@@ -360,8 +379,14 @@ void Mail::prepareTemplateItems(Player* receiver)
     // can be empty
     mailLoot.FillLoot(mailTemplateId, LootTemplates_Mail, receiver, true, true);
 
+    static SqlStatementID updHasItems ;
+    static SqlStatementID insMailItem ;
+
     CharacterDatabase.BeginTransaction();
-    CharacterDatabase.PExecute("UPDATE mail SET has_items = 1 WHERE id = %u", messageID);
+    SqlStatement stmt = CharacterDatabase.CreateStatement(updHasItems, "UPDATE mail SET has_items = 1 WHERE id = ?");
+    stmt.PExecute(messageID);
+
+    stmt = CharacterDatabase.CreateStatement(insMailItem, "INSERT INTO mail_items (mail_id,item_guid,item_template,receiver) VALUES (?, ?, ?, ?)");
 
     uint32 max_slot = mailLoot.GetMaxSlotInLootFor(receiver);
     for (uint32 i = 0; items.size() < MAX_MAIL_ITEMS && i < max_slot; ++i)
@@ -376,8 +401,7 @@ void Mail::prepareTemplateItems(Player* receiver)
 
                 receiver->AddMItem(item);
 
-                CharacterDatabase.PExecute("INSERT INTO mail_items (mail_id,item_guid,item_template,receiver) VALUES ('%u', '%u', '%u','%u')",
-                                           messageID, item->GetGUIDLow(), item->GetEntry(), receiver->GetGUIDLow());
+                stmt.PExecute(messageID, item->GetGUIDLow(), item->GetEntry(), receiver->GetGUIDLow());
             }
         }
     }
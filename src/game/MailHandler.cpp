@@ -296,7 +296,10 @@ void WorldSession::HandleSendMail(WorldPacket& recv_data)
                 item->DeleteFromInventoryDB();              // deletes item from character's inventory
                 item->SaveToDB();                           // recursive and not have transaction guard into self, item not in inventory and can be save standalone
                 // owner in data will set at mail receive and item extracting
-                CharacterDatabase.PExecute("UPDATE item_instance SET owner_guid = '%u' WHERE guid='%u'", rc.GetCounter(), item->GetGUIDLow());
+                static SqlStatementID updItemOwner ;
+
+                SqlStatement stmt = CharacterDatabase.CreateStatement(updItemOwner, "UPDATE item_instance SET owner_guid = ? WHERE guid = ?");
+                stmt.PExecute(rc.GetCounter(), item->GetGUIDLow());
                 CharacterDatabase.CommitTransaction();
 
                 draft.AddItem(item);
@@ -425,10 +428,15 @@ void WorldSession::HandleMailReturnToSender(WorldPacket& recv_data)
 
     // we can return mail now
     // so firstly delete the old one
+    static SqlStatementID delMail ;
+    static SqlStatementID delMailItems ;
+
     CharacterDatabase.BeginTransaction();
-    CharacterDatabase.PExecute("DELETE FROM mail WHERE id = '%u'", mailId);
+    SqlStatement stmt = CharacterDatabase.CreateStatement(delMail, "DELETE FROM mail WHERE id = ?");
+    stmt.PExecute(mailId);
     // needed?
-    CharacterDatabase.PExecute("DELETE FROM mail_items WHERE mail_id = '%u'", mailId);
+    stmt = CharacterDatabase.CreateStatement(delMailItems, "DELETE FROM mail_items WHERE mail_id = ?");
+    stmt.PExecute(mailId);
     CharacterDatabase.CommitTransaction();
     pl->RemoveMail(mailId);
 
@@ -35,12 +35,17 @@
 #include "DBCEnums.h"
 #include "MapPersistentStateMgr.h"
 #include "VMapFactory.h"
-#include "MoveMap.h"
 #include "BattleGround/BattleGroundMgr.h"
 #include "Calendar.h"
+#include "MapUpdater.h"
+#include "Utilities/Callback.h"
 
 Map::~Map()
 {
+    // pending actions may reference objects of this map, not safe to execute anymore
+    for (CrossMapActions::const_iterator itr = m_crossMapActions.begin(); itr != m_crossMapActions.end(); ++itr)
+        delete *itr;
+
     UnloadAll(true);
 
     if (!m_scriptSchedule.empty())
@@ -52,9 +57,6 @@ Map::~Map()
     delete i_data;
     i_data = NULL;
 
-    // unload instance specific navigation data
-    MMAP::MMapFactory::createOrGetMMapManager()->unloadMapInstance(m_TerrainData->GetMapId(), GetInstanceId());
-
     // release reference count
     if (m_TerrainData->Release())
         sTerrainMgr.UnloadTerrain(m_TerrainData->GetMapId());
@@ -73,9 +75,8 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
     : i_mapEntry(sMapStore.LookupEntry(id)), i_spawnMode(SpawnMode),
       i_id(id), i_InstanceId(InstanceId), m_unloadTimer(0),
       m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE), m_persistentState(NULL),
-      m_activeNonPlayersIter(m_activeNonPlayers.end()),
-      i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)),
-      i_data(NULL), i_script_id(0)
+      i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)), m_visitedCellsCount(0),
+      i_data(NULL), i_script_id(0), m_lastUpdateTime(0)
 {
     m_CreatureGuids.Set(sObjectMgr.GetFirstTemporaryCreatureLowGuid());
     m_GameObjectGuids.Set(sObjectMgr.GetFirstTemporaryGameObjectLowGuid());
@@ -282,6 +283,36 @@ void Map::LoadGrid(const Cell& cell, bool no_unload)
         getNGrid(cell.GridX(), cell.GridY())->setUnloadExplicitLock(true);
 }
 
+void Map::PreloadTerrain(float x, float y)
+{
+    if (!MaNGOS::IsValidMapCoord(x, y))
+        return;
+
+    GridPair p = MaNGOS::ComputeGridPair(x, y);
+
+    // z coord
+    int gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+    int gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+
+    if (!m_bLoadedGrids[gx][gy])
+        m_TerrainData->Preload(gx, gy);
+}
+
+void Map::PreloadTerrainAhead(Player* player)
+{
+    uint32 distance = sWorld.getConfig(CONFIG_UINT32_GRID_PRELOAD_DISTANCE);
+    if (!distance || !player->HasMovementFlag(MOVEFLAG_FORWARD))
+        return;
+
+    // grids along the heading, steps of half a grid do not skip any grid on the way
+    float angle = player->GetOrientation();
+    for (float dist = SIZE_OF_GRIDS / 2; dist < distance + SIZE_OF_GRIDS / 2; dist += SIZE_OF_GRIDS / 2)
+    {
+        float step = std::min(dist, float(distance));
+        PreloadTerrain(player->GetPositionX() + step * cos(angle), player->GetPositionY() + step * sin(angle));
+    }
+}
+
 bool Map::Add(Player* player)
 {
     player->GetMapRef().link(this, player);
@@ -292,6 +323,7 @@ bool Map::Add(Player* player)
     Cell cell(p);
     EnsureGridLoadedAtEnter(cell, player);
     player->AddToWorld();
+    AddActiveCellArea(player);
 
     SendInitSelf(player);
     SendInitTransports(player);
@@ -462,85 +494,26 @@ void Map::Update(const uint32& t_diff)
     }
 
     /// update active cells around players and active objects
-    resetMarkedCells();
-
     MaNGOS::ObjectUpdater updater(t_diff);
     // for creature
     TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
     // for pets
     TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
 
-    // the player iterator is stored in the map object
-    // to make sure calls to Map::Remove don't invalidate it
-    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
-    {
-        Player* plr = m_mapRefIter->getSource();
-
-        if (!plr->IsInWorld() || !plr->IsPositionValid())
-            continue;
-
-        // lets update mobs/objects in ALL visible cells around player!
-        CellArea area = Cell::CalculateCellArea(plr->GetPositionX(), plr->GetPositionY(), GetVisibilityDistance());
-
-        for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
-        {
-            for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
-            {
-                // marked cells are those that have been visited
-                // don't visit the same cell twice
-                uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                if (!isCellMarked(cell_id))
-                {
-                    markCell(cell_id);
-                    CellPair pair(x, y);
-                    Cell cell(pair);
-                    cell.SetNoCreate();
-                    Visit(cell, grid_object_update);
-                    Visit(cell, world_object_update);
-                }
-            }
-        }
-    }
+    // objects moving in this loop change the active cells, newly activated cells are updated at next tick
+    m_updateCells = m_activeCells;
 
-    // non-player active objects
-    if (!m_activeNonPlayers.empty())
+    for (std::vector<uint32>::const_iterator itr = m_updateCells.begin(); itr != m_updateCells.end(); ++itr)
     {
-        for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); m_activeNonPlayersIter != m_activeNonPlayers.end();)
-        {
-            // skip not in world
-            WorldObject* obj = *m_activeNonPlayersIter;
-
-            // step before processing, in this case if Map::Remove remove next object we correctly
-            // step to next-next, and if we step to end() then newly added objects can wait next update.
-            ++m_activeNonPlayersIter;
-
-            if (!obj->IsInWorld() || !obj->IsPositionValid())
-                continue;
-
-            // lets update mobs/objects in ALL visible cells around player!
-            CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), GetVisibilityDistance());
-
-            for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
-            {
-                for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
-                {
-                    // marked cells are those that have been visited
-                    // don't visit the same cell twice
-                    uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                    if (!isCellMarked(cell_id))
-                    {
-                        markCell(cell_id);
-                        CellPair pair(x, y);
-                        Cell cell(pair);
-                        cell.SetNoCreate();
-                        Visit(cell, grid_object_update);
-                        Visit(cell, world_object_update);
-                    }
-                }
-            }
-        }
+        CellPair pair(*itr % TOTAL_NUMBER_OF_CELLS_PER_MAP, *itr / TOTAL_NUMBER_OF_CELLS_PER_MAP);
+        Cell cell(pair);
+        cell.SetNoCreate();
+        Visit(cell, grid_object_update);
+        Visit(cell, world_object_update);
     }
 
+    m_visitedCellsCount = m_updateCells.size();
+
     // Send world objects and item update field changes
     SendObjectUpdates();
 
@@ -566,11 +539,33 @@ void Map::Update(const uint32& t_diff)
         i_data->Update(t_diff);
 }
 
+void Map::DeferCrossMapAction(MaNGOS::ICallback* action)
+{
+    m_crossMapActions.push_back(action);
+}
+
+void Map::ExecuteCrossMapActions()
+{
+    MANGOS_ASSERT_NOT_MAP_WORKER();
+
+    // actions can queue new actions, those are executed at next tick
+    CrossMapActions actions;
+    actions.swap(m_crossMapActions);
+
+    for (CrossMapActions::const_iterator itr = actions.begin(); itr != actions.end(); ++itr)
+    {
+        (*itr)->Execute();
+        delete *itr;
+    }
+}
+
 void Map::Remove(Player* player, bool remove)
 {
     if (i_data)
         i_data->OnPlayerLeave(player);
 
+    RemoveActiveCellArea(player);
+
     if (remove)
         player->CleanupsBeforeDelete();
     else
@@ -687,10 +682,14 @@ Map::PlayerRelocation(Player* player, float x, float y, float z, float orientati
 
         NGridType* newGrid = getNGrid(new_cell.GridX(), new_cell.GridY());
         player->GetViewPoint().Event_GridChanged(&(*newGrid)(new_cell.CellX(), new_cell.CellY()));
+
+        PreloadTerrainAhead(player);
     }
 
     player->OnRelocated();
 
+    RelocateActiveCellArea(player);
+
     NGridType* newGrid = getNGrid(new_cell.GridX(), new_cell.GridY());
     if (!same_cell && newGrid->GetGridState() != GRID_STATE_ACTIVE)
     {
@@ -712,6 +711,9 @@ void Map::CreatureRelocation(Creature* creature, float x, float y, float z, floa
         // update pos
         creature->Relocate(x, y, z, ang);
         creature->OnRelocated();
+
+        if (creature->isActiveObject())
+            RelocateActiveCellArea(creature);
     }
     // if creature can't be move in new cell/grid (not loaded) move it to repawn cell/grid
     // creature coordinates will be updated and notifiers send
@@ -768,6 +770,9 @@ bool Map::CreatureRespawnRelocation(Creature* c)
         c->Relocate(resp_x, resp_y, resp_z, resp_o);
         c->GetMotionMaster()->Initialize();                 // prevent possible problems with default move generators
         c->OnRelocated();
+
+        if (c->isActiveObject())
+            RelocateActiveCellArea(c);
         return true;
     }
     else
@@ -1087,6 +1092,7 @@ void Map::AddToActive(WorldObject* obj)
     m_activeNonPlayers.insert(obj);
     Cell cell = Cell(MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY()));
     EnsureGridLoaded(cell);
+    AddActiveCellArea(obj);
 
     // also not allow unloading spawn grid to prevent creating creature clone at load
     if (obj->GetTypeId() == TYPEID_UNIT)
@@ -1112,16 +1118,8 @@ void Map::AddToActive(WorldObject* obj)
 
 void Map::RemoveFromActive(WorldObject* obj)
 {
-    // Map::Update for active object in proccess
-    if (m_activeNonPlayersIter != m_activeNonPlayers.end())
-    {
-        ActiveNonPlayers::iterator itr = m_activeNonPlayers.find(obj);
-        if (itr == m_activeNonPlayersIter)
-            ++m_activeNonPlayersIter;
-        m_activeNonPlayers.erase(itr);
-    }
-    else
-        m_activeNonPlayers.erase(obj);
+    m_activeNonPlayers.erase(obj);
+    RemoveActiveCellArea(obj);
 
     // also allow unloading spawn grid
     if (obj->GetTypeId() == TYPEID_UNIT)
@@ -1145,6 +1143,104 @@ void Map::RemoveFromActive(WorldObject* obj)
     }
 }
 
+void Map::AddActiveCellArea(WorldObject const* obj)
+{
+    if (!obj->IsPositionValid())
+        return;
+
+    CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), GetVisibilityDistance());
+
+    std::pair<ActiveCellAreas::iterator, bool> result = m_activeCellAreas.insert(ActiveCellAreas::value_type(obj, area));
+    if (!result.second)
+        return;
+
+    IncActiveCellRefs(area);
+}
+
+void Map::RemoveActiveCellArea(WorldObject const* obj)
+{
+    ActiveCellAreas::iterator itr = m_activeCellAreas.find(obj);
+    if (itr == m_activeCellAreas.end())
+        return;
+
+    DecActiveCellRefs(itr->second);
+    m_activeCellAreas.erase(itr);
+}
+
+void Map::RelocateActiveCellArea(WorldObject const* obj)
+{
+    ActiveCellAreas::iterator itr = m_activeCellAreas.find(obj);
+    if (itr == m_activeCellAreas.end())
+        return;
+
+    CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), GetVisibilityDistance());
+    if (area.low_bound == itr->second.low_bound && area.high_bound == itr->second.high_bound)
+        return;
+
+    // add the new area first so cells shared by both areas never drop out of the active list
+    IncActiveCellRefs(area);
+    DecActiveCellRefs(itr->second);
+    itr->second = area;
+}
+
+void Map::IncActiveCellRefs(CellArea const& area)
+{
+    for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+    {
+        for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+        {
+            uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
+            ActiveCellRefs::iterator itr = m_activeCellRefs.find(cell_id);
+            if (itr != m_activeCellRefs.end())
+            {
+                ++itr->second.refs;
+                continue;
+            }
+
+            ActiveCellRef& ref = m_activeCellRefs[cell_id];
+            ref.refs = 1;
+            ref.index = m_activeCells.size();
+            m_activeCells.push_back(cell_id);
+        }
+    }
+}
+
+void Map::DecActiveCellRefs(CellArea const& area)
+{
+    for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+    {
+        for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+        {
+            uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
+            ActiveCellRefs::iterator itr = m_activeCellRefs.find(cell_id);
+            MANGOS_ASSERT(itr != m_activeCellRefs.end());
+
+            if (--itr->second.refs)
+                continue;
+
+            // swap with the last cell of the list to keep the removal O(1)
+            uint32 index = itr->second.index;
+            uint32 last_id = m_activeCells.back();
+            m_activeCells[index] = last_id;
+            m_activeCellRefs[last_id].index = index;
+            m_activeCells.pop_back();
+            m_activeCellRefs.erase(itr);
+        }
+    }
+}
+
+void Map::RebuildActiveCells()
+{
+    m_activeCellRefs.clear();
+    m_activeCells.clear();
+
+    for (ActiveCellAreas::iterator itr = m_activeCellAreas.begin(); itr != m_activeCellAreas.end(); ++itr)
+    {
+        itr->second = Cell::CalculateCellArea(itr->first->GetPositionX(), itr->first->GetPositionY(), GetVisibilityDistance());
+        IncActiveCellRefs(itr->second);
+    }
+}
+
 void Map::CreateInstanceData(bool load)
 {
     if (i_data != NULL)
@@ -1959,6 +2055,21 @@ bool Map::IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float
            && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, phasemask);
 }
 
+/**
+ * Batched version of the check above for lines close to each other, the result is stored in the queries
+ */
+void Map::IsInLineOfSight(VMAP::LineOfSightQuery* queries, uint32 count) const
+{
+    VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), queries, count);
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        VMAP::LineOfSightQuery& query = queries[i];
+        if (query.result)
+            query.result = m_dyn_tree.isInLineOfSight(query.srcX, query.srcY, query.srcZ, query.destX, query.destY, query.destZ, query.phaseMask);
+    }
+}
+
 /**
  * get the hit position and return true if we hit something (in this case the dest position will hold the hit-position)
  * otherwise the result pos will be the dest pos
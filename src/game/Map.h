@@ -39,7 +39,6 @@
 #include "CreatureLinkingMgr.h"
 #include "vmap/DynamicTree.h"
 
-#include <bitset>
 #include <list>
 
 struct CreatureInfo;
@@ -57,6 +56,16 @@ class BattleGround;
 class GridMap;
 class GameObjectModel;
 
+namespace MaNGOS
+{
+    class ICallback;
+}
+
+namespace VMAP
+{
+    struct LineOfSightQuery;
+}
+
 // GCC have alternative #pragma pack(N) syntax and old gcc version not support pack(push,N), also any gcc version not support it at some platform
 #if defined( __GNUC__ )
 #pragma pack(1)
@@ -123,6 +132,15 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
 
         virtual void Update(const uint32&);
 
+        // time in ms the last Update() call took, measured by MapUpdater
+        uint32 GetLastUpdateTime() const { return m_lastUpdateTime; }
+        void SetLastUpdateTime(uint32 time) { m_lastUpdateTime = time; }
+
+        // queue an action touching global state or other maps, executed single threaded after all maps were updated
+        void DeferCrossMapAction(MaNGOS::ICallback* action);
+        // called by MapManager only, outside of the parallel map update
+        void ExecuteCrossMapActions();
+
         void MessageBroadcast(Player const*, WorldPacket*, bool to_self);
         void MessageBroadcast(WorldObject const*, WorldPacket*);
         void MessageDistBroadcast(Player const*, WorldPacket*, float dist, bool to_self, bool own_team_only = false);
@@ -152,6 +170,8 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
         bool GetUnloadLock(const GridPair& p) const { return getNGrid(p.x_coord, p.y_coord)->getUnloadLock(); }
         void SetUnloadLock(const GridPair& p, bool on) { getNGrid(p.x_coord, p.y_coord)->setUnloadExplicitLock(on); }
         void LoadGrid(const Cell& cell, bool no_unload = false);
+        // start loading terrain data of the grid at x,y in background, used ahead of moving players
+        void PreloadTerrain(float x, float y);
         bool UnloadGrid(const uint32& x, const uint32& y, bool pForce);
         virtual void UnloadAll(bool pForce);
 
@@ -204,9 +224,10 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
 
         void UpdateObjectVisibility(WorldObject* obj, Cell cell, CellPair cellpair);
 
-        void resetMarkedCells() { marked_cells.reset(); }
-        bool isCellMarked(uint32 pCellId) { return marked_cells.test(pCellId); }
-        void markCell(uint32 pCellId) { marked_cells.set(pCellId); }
+        // cells in visibility range of players and active objects, these are updated each tick
+        void RebuildActiveCells();
+        uint32 GetActiveCellsCount() const { return m_activeCells.size(); }
+        uint32 GetVisitedCellsCount() const { return m_visitedCellsCount; }
 
         bool HavePlayers() const { return !m_mapRefManager.isEmpty(); }
         uint32 GetPlayersCountExceptGMs() const;
@@ -273,6 +294,7 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
         // Dynamic VMaps
         float GetHeight(uint32 phasemask, float x, float y, float z) const;
         bool IsInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask) const;
+        void IsInLineOfSight(VMAP::LineOfSightQuery* queries, uint32 count) const;
         bool GetHitPosition(float srcX, float srcY, float srcZ, float& destX, float& destY, float& destZ, uint32 phasemask, float modifyDist) const;
 
         // Object Model insertion/remove/test for dynamic vmaps use
@@ -285,6 +307,7 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
 
     private:
         void LoadMapAndVMap(int gx, int gy);
+        void PreloadTerrainAhead(Player* player);
 
         void SetTimer(uint32 t) { i_gridExpiry = t < MIN_GRID_DELAY ? MIN_GRID_DELAY : t; }
 
@@ -335,7 +358,6 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
 
         typedef std::set<WorldObject*> ActiveNonPlayers;
         ActiveNonPlayers m_activeNonPlayers;
-        ActiveNonPlayers::iterator m_activeNonPlayersIter;
         MapStoredObjectTypesContainer m_objectsStore;
 
     private:
@@ -347,7 +369,26 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
         TerrainInfo* const m_TerrainData;
         bool m_bLoadedGrids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
-        std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP* TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
+        // reference counted set of active cells, maintained at add/remove/relocation of players and active objects
+        struct ActiveCellRef
+        {
+            uint32 refs;
+            uint32 index;                                   // position in m_activeCells
+        };
+        typedef UNORDERED_MAP<uint32 /*cell id*/, ActiveCellRef> ActiveCellRefs;
+        typedef UNORDERED_MAP<WorldObject const*, CellArea> ActiveCellAreas;
+
+        void AddActiveCellArea(WorldObject const* obj);
+        void RemoveActiveCellArea(WorldObject const* obj);
+        void RelocateActiveCellArea(WorldObject const* obj);
+        void IncActiveCellRefs(CellArea const& area);
+        void DecActiveCellRefs(CellArea const& area);
+
+        ActiveCellRefs m_activeCellRefs;
+        ActiveCellAreas m_activeCellAreas;                  // area each player and active object holds references for
+        std::vector<uint32> m_activeCells;                  // compact list of referenced cell ids
+        std::vector<uint32> m_updateCells;                  // copy of m_activeCells walked in Update(), objects may move meanwhile
+        uint32 m_visitedCellsCount;
 
         std::set<WorldObject*> i_objectsToRemove;
 
@@ -376,6 +417,11 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
 
         // Dynamic Map tree object
         DynamicMapTree m_dyn_tree;
+
+        uint32 m_lastUpdateTime;
+
+        typedef std::vector<MaNGOS::ICallback*> CrossMapActions;
+        CrossMapActions m_crossMapActions;
 };
 
 class MANGOS_DLL_SPEC WorldMap : public Map
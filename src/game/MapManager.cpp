@@ -33,7 +33,7 @@ INSTANTIATE_SINGLETON_2(MapManager, CLASS_LOCK);
 INSTANTIATE_CLASS_MUTEX(MapManager, ACE_Recursive_Thread_Mutex);
 
 MapManager::MapManager()
-    : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN))
+    : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN)), m_mapsUpdated(false)
 {
     i_timer.SetInterval(sWorld.getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
 }
@@ -53,6 +53,15 @@ void
 MapManager::Initialize()
 {
     InitStateMachine();
+
+    if (uint32 numThreads = sWorld.getConfig(CONFIG_UINT32_MAPUPDATE_THREADS))
+        m_updater.Activate(numThreads);
+
+    if (sWorld.getConfig(CONFIG_UINT32_GRID_PRELOAD_DISTANCE))
+        sTerrainMgr.GetPreloader().Activate();
+
+    if (uint32 pathThreads = sWorld.getConfig(CONFIG_UINT32_MMAP_PATH_THREADS))
+        m_pathRequests.Activate(pathThreads);
 }
 
 void MapManager::InitStateMachine()
@@ -83,7 +92,10 @@ void MapManager::UpdateGridState(grid_state_t state, Map& map, NGridType& ngrid,
 void MapManager::InitializeVisibilityDistanceInfo()
 {
     for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+    {
         (*iter).second->InitVisibilityDistance();
+        (*iter).second->RebuildActiveCells();               // active cell areas depend on the visibility distance
+    }
 }
 
 Map* MapManager::CreateMap(uint32 id, const WorldObject* obj)
@@ -167,14 +179,51 @@ void MapManager::DeleteInstance(uint32 mapid, uint32 instanceId)
     }
 }
 
+// slowest maps of the previous tick first, so they don't end up as the tail the barrier waits for
+static bool SortMapsByLastUpdateTime(Map const* first, Map const* second)
+{
+    return first->GetLastUpdateTime() > second->GetLastUpdateTime();
+}
+
 void MapManager::Update(uint32 diff)
 {
     i_timer.Update(diff);
-    if (!i_timer.Passed())
+    m_mapsUpdated = i_timer.Passed();
+    if (!m_mapsUpdated)
         return;
 
+    if (m_updater.IsActivated())
+    {
+        m_updateQueue.clear();
+        for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+            m_updateQueue.push_back(iter->second);
+
+        std::sort(m_updateQueue.begin(), m_updateQueue.end(), SortMapsByLastUpdateTime);
+
+        // returns only after all maps were updated
+        m_updater.Update(m_updateQueue, (uint32)i_timer.GetCurrent());
+    }
+    else
+    {
+        for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+            MapUpdater::UpdateMap(iter->second, (uint32)i_timer.GetCurrent());
+    }
+
+    // execute actions the maps couldn't do in parallel
     for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
-        iter->second->Update((uint32)i_timer.GetCurrent());
+        iter->second->ExecuteCrossMapActions();
+
+    if (uint32 slowMapTime = sWorld.getConfig(CONFIG_UINT32_MAPUPDATE_SLOW_LOG_TIME))
+    {
+        for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+        {
+            Map* pMap = iter->second;
+            if (pMap->GetLastUpdateTime() >= slowMapTime)
+                sLog.outString("MapManager: Map %u (%s) instance %u with %u players took %u ms to update (%u active cells visited)",
+                               pMap->GetId(), pMap->GetMapName(), pMap->GetInstanceId(), pMap->GetPlayers().getSize(), pMap->GetLastUpdateTime(),
+                               pMap->GetVisitedCellsCount());
+        }
+    }
 
     for (TransportSet::iterator iter = m_Transports.begin(); iter != m_Transports.end(); ++iter)
     {
@@ -227,6 +276,9 @@ bool MapManager::IsValidMAP(uint32 mapid)
 
 void MapManager::UnloadAll()
 {
+    m_updater.Deactivate();
+    m_pathRequests.Deactivate();
+
     for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
         iter->second->UnloadAll(true);
 
@@ -25,6 +25,8 @@
 #include "ace/Recursive_Thread_Mutex.h"
 #include "Map.h"
 #include "GridStates.h"
+#include "MapUpdater.h"
+#include "PathRequestService.h"
 
 class Transport;
 class BattleGround;
@@ -141,6 +143,8 @@ class MANGOS_DLL_DECL MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::
 
         void InitializeVisibilityDistanceInfo();
 
+        PathRequestService& GetPathRequests() { return m_pathRequests; }
+
         /* statistics */
         uint32 GetNumInstances();
         uint32 GetNumPlayersInInstances();
@@ -149,6 +153,9 @@ class MANGOS_DLL_DECL MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::
         // get list of all maps
         const MapMapType& Maps() const { return i_maps; }
 
+        // the last Update() call updated the maps, they are updated only once per map update interval
+        bool AreMapsUpdated() const { return m_mapsUpdated; }
+
         template<typename Do>
         void DoForAllMapsWithMapId(uint32 mapId, Do& _do);
 
@@ -176,6 +183,12 @@ class MANGOS_DLL_DECL MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::
         uint32 i_gridCleanUpDelay;
         MapMapType i_maps;
         IntervalTimer i_timer;
+        bool m_mapsUpdated;
+
+        MapUpdater m_updater;
+        MapUpdater::MapList m_updateQueue;                  // reused each tick to hand the maps over to m_updater
+
+        PathRequestService m_pathRequests;
 };
 
 template<typename Do>
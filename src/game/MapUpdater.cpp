@@ -0,0 +1,139 @@
+/**
+ * This code is part of MaNGOS. Contributor & Copyright details are in AUTHORS/THANKS.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "MapUpdater.h"
+#include "Map.h"
+#include "Timer.h"
+#include "Log.h"
+#include "Database/DatabaseEnv.h"
+
+class MapUpdateWorker : public ACE_Based::Runnable
+{
+    public:
+        explicit MapUpdateWorker(MapUpdater& updater) : m_updater(updater) {}
+
+        void run() override
+        {
+            WorldDatabase.ThreadStart();                    // let thread do safe mySQL requests
+            m_updater.WorkerLoop();
+            WorldDatabase.ThreadEnd();                      // free mySQL thread resources
+        }
+
+    private:
+        MapUpdater& m_updater;
+};
+
+MapUpdater::WorkerThreadFlag MapUpdater::m_isWorkerThread;
+
+MapUpdater::MapUpdater() :
+    m_workCondition(m_lock), m_doneCondition(m_lock),
+    m_batch(NULL), m_batchDiff(0), m_nextMap(0), m_pendingMaps(0), m_running(false)
+{
+}
+
+MapUpdater::~MapUpdater()
+{
+    Deactivate();
+}
+
+void MapUpdater::Activate(uint32 numThreads)
+{
+    if (IsActivated())
+        return;
+
+    m_running = true;
+
+    for (uint32 i = 0; i < numThreads; ++i)
+        m_workers.push_back(new ACE_Based::Thread(new MapUpdateWorker(*this)));
+
+    sLog.outString("Map updates will be processed by %u threads", numThreads);
+}
+
+void MapUpdater::Deactivate()
+{
+    if (!IsActivated())
+        return;
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+        m_running = false;
+        m_workCondition.broadcast();
+    }
+
+    for (WorkerThreads::iterator itr = m_workers.begin(); itr != m_workers.end(); ++itr)
+    {
+        (*itr)->wait();
+        delete *itr;
+    }
+
+    m_workers.clear();
+}
+
+void MapUpdater::Update(MapList const& maps, uint32 diff)
+{
+    if (maps.empty())
+        return;
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    m_batch = &maps;
+    m_batchDiff = diff;
+    m_nextMap = 0;
+    m_pendingMaps = maps.size();
+
+    m_workCondition.broadcast();
+
+    // barrier: the caller may only continue with single threaded work after all maps are done
+    while (m_pendingMaps)
+        m_doneCondition.wait();
+
+    m_batch = NULL;
+}
+
+void MapUpdater::UpdateMap(Map* map, uint32 diff)
+{
+    uint32 startTime = WorldTimer::getMSTime();
+    map->Update(diff);
+    map->SetLastUpdateTime(WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime()));
+}
+
+void MapUpdater::WorkerLoop()
+{
+    *m_isWorkerThread = true;
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    while (true)
+    {
+        while (m_running && (!m_batch || m_nextMap >= m_batch->size()))
+            m_workCondition.wait();
+
+        if (!m_running)
+            return;
+
+        Map* map = (*m_batch)[m_nextMap++];
+        uint32 diff = m_batchDiff;
+
+        m_lock.release();
+        UpdateMap(map, diff);
+        m_lock.acquire();
+
+        if (--m_pendingMaps == 0)
+            m_doneCondition.signal();
+    }
+}
@@ -0,0 +1,93 @@
+/**
+ * This code is part of MaNGOS. Contributor & Copyright details are in AUTHORS/THANKS.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MAPUPDATER_H
+#define MANGOS_MAPUPDATER_H
+
+#include "Common.h"
+#include "Threading.h"
+#include "ace/Thread_Mutex.h"
+#include "ace/Condition_Thread_Mutex.h"
+#include "ace/TSS_T.h"
+
+#include <vector>
+
+class Map;
+
+// Debug builds check that global, not thread-safe state is not modified from a map update worker.
+// Code running inside Map::Update that needs to do so has to use Map::DeferCrossMapAction() instead.
+#ifdef MANGOS_DEBUG
+#  define MANGOS_ASSERT_NOT_MAP_WORKER() MANGOS_ASSERT(!MapUpdater::IsWorkerThread())
+#else
+#  define MANGOS_ASSERT_NOT_MAP_WORKER()
+#endif
+
+/**
+ * Pool of worker threads used by MapManager to update independent maps concurrently.
+ *
+ * A batch of maps is handed over with Update(); workers claim the next not yet updated
+ * map from the shared batch as soon as they are idle, so a long running instance never
+ * blocks the maps queued behind it. Update() returns only after every map of the batch
+ * was processed, which acts as the barrier for the single threaded part of the tick.
+ */
+class MapUpdater
+{
+    public:
+        typedef std::vector<Map*> MapList;
+
+        MapUpdater();
+        ~MapUpdater();
+
+        void Activate(uint32 numThreads);
+        void Deactivate();
+        bool IsActivated() const { return !m_workers.empty(); }
+        uint32 GetThreadsCount() const { return m_workers.size(); }
+
+        // updates all maps of the batch in the worker threads, returns when all are done
+        void Update(MapList const& maps, uint32 diff);
+
+        // update a single map and store the time it took, used by the workers and by the world thread
+        static void UpdateMap(Map* map, uint32 diff);
+
+        // true only for the threads owned by a MapUpdater, the world thread is never a worker
+        static bool IsWorkerThread() { return *m_isWorkerThread; }
+
+    private:
+        friend class MapUpdateWorker;
+
+        // worker thread body, returns when the updater is deactivated
+        void WorkerLoop();
+
+        typedef std::vector<ACE_Based::Thread*> WorkerThreads;
+        WorkerThreads m_workers;
+
+        typedef ACE_TSS<ACE_TSS_Type_Adapter<bool> > WorkerThreadFlag;
+        static WorkerThreadFlag m_isWorkerThread;
+
+        ACE_Thread_Mutex m_lock;
+        ACE_Condition_Thread_Mutex m_workCondition;         ///< signaled when a new batch is available or at shutdown
+        ACE_Condition_Thread_Mutex m_doneCondition;         ///< signaled when the last map of a batch was updated
+
+        MapList const* m_batch;                             ///< maps of the current tick, NULL when idle
+        uint32 m_batchDiff;
+        size_t m_nextMap;                                   ///< index of the next map to be claimed by a worker
+        size_t m_pendingMaps;                               ///< maps of the batch not yet updated
+        bool m_running;
+};
+
+#endif
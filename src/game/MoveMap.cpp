@@ -23,6 +23,8 @@
 #include "MoveMap.h"
 #include "MoveMapSharedDefines.h"
 
+#include "../../dep/recastnavigation/Detour/Include/DetourNode.h"
+
 namespace MMAP
 {
     // ######################## MMapFactory ########################
@@ -74,6 +76,61 @@ namespace MMAP
         g_MMapManager = NULL;
     }
 
+    // ######################## NavMeshQueryPool ########################
+    NavMeshQueryPool::~NavMeshQueryPool()
+    {
+        // the queries do not touch their mesh when freed, it may be gone already
+        for (uint32 i = 0; i < MMAP_MAX_QUERIES_PER_THREAD; ++i)
+            dtFreeNavMeshQuery(m_queries[i].query);
+    }
+
+    dtNavMeshQuery* NavMeshQueryPool::GetQuery(uint32 mapId, dtNavMesh const* navMesh, bool& created, bool& evicted)
+    {
+        created = false;
+        evicted = false;
+
+        PooledQuery* slot = NULL;
+        for (uint32 i = 0; i < MMAP_MAX_QUERIES_PER_THREAD; ++i)
+        {
+            PooledQuery& pooled = m_queries[i];
+            if (pooled.query && pooled.mapId == mapId)
+            {
+                slot = &pooled;
+                break;
+            }
+
+            // otherwise prefer an unused slot, then the least recently used one
+            if (!slot || (slot->query && (!pooled.query || pooled.lastUse < slot->lastUse)))
+                slot = &pooled;
+        }
+
+        if (!slot->query)
+        {
+            slot->query = dtAllocNavMeshQuery();
+            MANGOS_ASSERT(slot->query);
+            created = true;
+        }
+        else if (slot->mapId != mapId)
+            evicted = true;
+
+        if (slot->mapId != mapId || slot->navMesh != navMesh)
+        {
+            // init keeps the node pools if they are large enough, reusing a query costs no allocation
+            if (DT_SUCCESS != slot->query->init(navMesh, MMAP_QUERY_MAX_NODES))
+            {
+                dtFreeNavMeshQuery(slot->query);
+                *slot = PooledQuery();
+                return NULL;
+            }
+
+            slot->mapId = mapId;
+            slot->navMesh = navMesh;
+        }
+
+        slot->lastUse = ++m_useCounter;
+        return slot->query;
+    }
+
     // ######################## MMapManager ########################
     MMapManager::~MMapManager()
     {
@@ -84,6 +141,7 @@ namespace MMAP
         // if we had, tiles in MMapData->mmapLoadedTiles, their actual data is lost!
     }
 
+    // called with m_lock held
     bool MMapManager::loadMapData(uint32 mapId)
     {
         // we already have this map loaded?
@@ -135,14 +193,22 @@ namespace MMAP
         return uint32(x << 16 | y);
     }
 
-    bool MMapManager::loadMap(uint32 mapId, int32 x, int32 y)
+    bool MMapManager::loadMap(uint32 mapId, int32 x, int32 y, unsigned char* tileData, uint32 tileDataSize)
     {
-        // make sure the mmap is loaded and ready to load tiles
-        if (!loadMapData(mapId))
-            return false;
+        MMapData* mmap;
+        {
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, false);
 
-        // get this mmap data
-        MMapData* mmap = loadedMMaps[mapId];
+            // make sure the mmap is loaded and ready to load tiles
+            if (!loadMapData(mapId))
+            {
+                dtFree(tileData);
+                return false;
+            }
+
+            // get this mmap data
+            mmap = loadedMMaps[mapId];
+        }
         MANGOS_ASSERT(mmap->navMesh);
 
         // check if we already have this tile loaded
@@ -150,10 +216,36 @@ namespace MMAP
         if (mmap->mmapLoadedTiles.find(packedGridPos) != mmap->mmapLoadedTiles.end())
         {
             sLog.outError("MMAP:loadMap: Asked to load already loaded navmesh tile. %03u%02i%02i.mmtile", mapId, x, y);
+            dtFree(tileData);
             return false;
         }
 
         // load this tile :: mmaps/MMMXXYY.mmtile
+        unsigned char* data = tileData ? tileData : readTileData(mapId, x, y, tileDataSize);
+        if (!data)
+            return false;
+
+        dtMeshHeader* header = (dtMeshHeader*)data;
+        dtTileRef tileRef = 0;
+
+        ACE_WRITE_GUARD_RETURN(ACE_RW_Thread_Mutex, navMeshGuard, m_navMeshLock, false);
+
+        // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
+        if (mmap->navMesh->addTile(data, tileDataSize, DT_TILE_FREE_DATA, 0, &tileRef) != DT_SUCCESS)
+        {
+            sLog.outError("MMAP:loadMap: Could not load %03u%02i%02i.mmtile into navmesh", mapId, x, y);
+            dtFree(data);
+            return false;
+        }
+
+        mmap->mmapLoadedTiles.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
+        ++loadedTiles;
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:loadMap: Loaded mmtile %03i[%02i,%02i] into %03i[%02i,%02i]", mapId, x, y, mapId, header->x, header->y);
+        return true;
+    }
+
+    unsigned char* MMapManager::readTileData(uint32 mapId, int32 x, int32 y, uint32& dataSize)
+    {
         uint32 pathLen = sWorld.GetDataPath().length() + strlen("mmaps/%03i%02i%02i.mmtile") + 1;
         char* fileName = new char[pathLen];
         snprintf(fileName, pathLen, (sWorld.GetDataPath() + "mmaps/%03i%02i%02i.mmtile").c_str(), mapId, x, y);
@@ -163,7 +255,7 @@ namespace MMAP
         {
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "ERROR: MMAP:loadMap: Could not open mmtile file '%s'", fileName);
             delete[] fileName;
-            return false;
+            return NULL;
         }
         delete[] fileName;
 
@@ -175,7 +267,7 @@ namespace MMAP
         {
             sLog.outError("MMAP:loadMap: Bad header in mmap %03u%02i%02i.mmtile", mapId, x, y);
             fclose(file);
-            return false;
+            return NULL;
         }
 
         if (fileHeader.mmapVersion != MMAP_VERSION)
@@ -183,7 +275,7 @@ namespace MMAP
             sLog.outError("MMAP:loadMap: %03u%02i%02i.mmtile was built with generator v%i, expected v%i",
                           mapId, x, y, fileHeader.mmapVersion, MMAP_VERSION);
             fclose(file);
-            return false;
+            return NULL;
         }
 
         unsigned char* data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
@@ -194,39 +286,33 @@ namespace MMAP
         {
             sLog.outError("MMAP:loadMap: Bad header or data in mmap %03u%02i%02i.mmtile", mapId, x, y);
             fclose(file);
-            return false;
+            dtFree(data);
+            return NULL;
         }
 
         fclose(file);
 
-        dtMeshHeader* header = (dtMeshHeader*)data;
-        dtTileRef tileRef = 0;
-
-        // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
-        if (mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef) != DT_SUCCESS)
-        {
-            sLog.outError("MMAP:loadMap: Could not load %03u%02i%02i.mmtile into navmesh", mapId, x, y);
-            dtFree(data);
-            return false;
-        }
-
-        mmap->mmapLoadedTiles.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
-        ++loadedTiles;
-        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:loadMap: Loaded mmtile %03i[%02i,%02i] into %03i[%02i,%02i]", mapId, x, y, mapId, header->x, header->y);
-        return true;
+        dataSize = fileHeader.size;
+        return data;
     }
 
     bool MMapManager::unloadMap(uint32 mapId, int32 x, int32 y)
     {
-        // check if we have this map loaded
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        MMapData* mmap;
         {
-            // file may not exist, therefore not loaded
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Asked to unload not loaded navmesh map. %03u%02i%02i.mmtile", mapId, x, y);
-            return false;
-        }
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, false);
 
-        MMapData* mmap = loadedMMaps[mapId];
+            // check if we have this map loaded
+            MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+            if (itr == loadedMMaps.end())
+            {
+                // file may not exist, therefore not loaded
+                DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Asked to unload not loaded navmesh map. %03u%02i%02i.mmtile", mapId, x, y);
+                return false;
+            }
+
+            mmap = itr->second;
+        }
 
         // check if we have this tile loaded
         uint32 packedGridPos = packTileID(x, y);
@@ -239,6 +325,8 @@ namespace MMAP
 
         dtTileRef tileRef = mmap->mmapLoadedTiles[packedGridPos];
 
+        ACE_WRITE_GUARD_RETURN(ACE_RW_Thread_Mutex, navMeshGuard, m_navMeshLock, false);
+
         // unload, and mark as non loaded
         if (DT_SUCCESS != mmap->navMesh->removeTile(tileRef, NULL, NULL))
         {
@@ -261,6 +349,9 @@ namespace MMAP
 
     bool MMapManager::unloadMap(uint32 mapId)
     {
+        ACE_WRITE_GUARD_RETURN(ACE_RW_Thread_Mutex, navMeshGuard, m_navMeshLock, false);
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, false);
+
         if (loadedMMaps.find(mapId) == loadedMMaps.end())
         {
             // file may not exist, therefore not loaded
@@ -290,62 +381,72 @@ namespace MMAP
         return true;
     }
 
-    bool MMapManager::unloadMapInstance(uint32 mapId, uint32 instanceId)
+    dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId)
     {
-        // check if we have this map loaded
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, NULL);
+
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        if (itr == loadedMMaps.end())
+            return NULL;
+
+        return itr->second->navMesh;
+    }
+
+    dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId)
+    {
+        dtNavMesh const* navMesh = GetNavMesh(mapId);
+        if (!navMesh)
+            return NULL;
+
+        NavMeshQueryPool* pool = m_queryPools.ts_object();
+        if (!pool)
+            return NULL;
+
+        bool created, evicted;
+        dtNavMeshQuery* query = pool->GetQuery(mapId, navMesh, created, evicted);
+        if (!query)
         {
-            // file may not exist, therefore not loaded
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Asked to unload not loaded navmesh map %03u", mapId);
-            return false;
+            sLog.outError("MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u", mapId);
+            return NULL;
         }
 
-        MMapData* mmap = loadedMMaps[mapId];
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
+        if (created)
         {
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId %03u instanceId %u", mapId, instanceId);
-            return false;
+            ++m_queriesCreated;
+            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u", mapId);
         }
 
-        dtNavMeshQuery* query = mmap->navMeshQueries[instanceId];
+        if (evicted)
+            ++m_queriesEvicted;
 
-        dtFreeNavMeshQuery(query);
-        mmap->navMeshQueries.erase(instanceId);
-        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Unloaded mapId %03u instanceId %u", mapId, instanceId);
-
-        return true;
+        return query;
     }
 
-    dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId)
+    void MMapManager::CountPathSearch(dtNavMeshQuery const* query)
     {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
-            return NULL;
+        ++m_pathSearches;
 
-        return loadedMMaps[mapId]->navMesh;
+        dtNodePool const* nodePool = query->getNodePool();
+        if (nodePool && nodePool->getNodeCount() >= nodePool->getMaxNodes())
+            ++m_nodeExhaustions;
     }
 
-    dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instanceId)
+    // subtracting what was read keeps the counts added by other threads meanwhile
+    static uint32 ReadCounter(MMapCounter& counter, bool reset)
     {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
-            return NULL;
-
-        MMapData* mmap = loadedMMaps[mapId];
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
-        {
-            // allocate mesh query
-            dtNavMeshQuery* query = dtAllocNavMeshQuery();
-            MANGOS_ASSERT(query);
-            if (DT_SUCCESS != query->init(mmap->navMesh, 1024))
-            {
-                dtFreeNavMeshQuery(query);
-                sLog.outError("MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-                return NULL;
-            }
-
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-            mmap->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(instanceId, query));
-        }
+        long value = counter.value();
+        if (reset)
+            counter -= value;
+        return uint32(value);
+    }
 
-        return mmap->navMeshQueries[instanceId];
+    NavMeshQueryStats MMapManager::GetQueryStats(bool reset)
+    {
+        NavMeshQueryStats stats;
+        stats.pathSearches = ReadCounter(m_pathSearches, reset);
+        stats.nodeExhaustions = ReadCounter(m_nodeExhaustions, reset);
+        stats.queriesCreated = ReadCounter(m_queriesCreated, reset);
+        stats.queriesEvicted = ReadCounter(m_queriesEvicted, reset);
+        return stats;
     }
 }
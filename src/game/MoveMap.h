@@ -20,6 +20,10 @@
 #define _MOVE_MAP_H
 
 #include "Utilities/UnorderedMapSet.h"
+#include "ace/Thread_Mutex.h"
+#include "ace/RW_Thread_Mutex.h"
+#include "ace/TSS_T.h"
+#include "ace/Atomic_Op.h"
 
 #include "../../dep/recastnavigation/Detour/Include/DetourAlloc.h"
 #include "../../dep/recastnavigation/Detour/Include/DetourNavMesh.h"
@@ -36,11 +40,15 @@ inline void dtCustomFree(void* ptr)
     delete[](unsigned char*)ptr;
 }
 
+// search nodes of every dtNavMeshQuery, a path search gives up when they are used up
+#define MMAP_QUERY_MAX_NODES            1024
+// dtNavMeshQuery objects kept by one thread, the least recently used one is reused for another map
+#define MMAP_MAX_QUERIES_PER_THREAD     4
+
 //  move map related classes
 namespace MMAP
 {
     typedef UNORDERED_MAP<uint32, dtTileRef> MMapTileSet;
-    typedef UNORDERED_MAP<uint32, dtNavMeshQuery*> NavMeshQuerySet;
 
     // dummy struct to hold map's mmap data
     struct MMapData
@@ -48,23 +56,54 @@ namespace MMAP
         MMapData(dtNavMesh* mesh) : navMesh(mesh) {}
         ~MMapData()
         {
-            for (NavMeshQuerySet::iterator i = navMeshQueries.begin(); i != navMeshQueries.end(); ++i)
-                dtFreeNavMeshQuery(i->second);
-
             if (navMesh)
                 dtFreeNavMesh(navMesh);
         }
 
         dtNavMesh* navMesh;
-
-        // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        NavMeshQuerySet navMeshQueries;     // instanceId to query
         MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
     };
 
 
     typedef UNORDERED_MAP<uint32, MMapData*> MMapDataSet;
 
+    // dtNavMeshQuery objects are not thread safe, every thread using pathfinding gets its own
+    class NavMeshQueryPool
+    {
+        public:
+            NavMeshQueryPool() : m_useCounter(0) {}
+            ~NavMeshQueryPool();
+
+            // returns a query for the mesh, NULL if it can not be initialized
+            dtNavMeshQuery* GetQuery(uint32 mapId, dtNavMesh const* navMesh, bool& created, bool& evicted);
+
+        private:
+            struct PooledQuery
+            {
+                PooledQuery() : mapId(0), navMesh(NULL), query(NULL), lastUse(0) {}
+
+                uint32 mapId;
+                dtNavMesh const* navMesh;   // mesh the query was initialized for, a map unloaded and loaded again gets a new one
+                dtNavMeshQuery* query;
+                uint32 lastUse;
+            };
+
+            PooledQuery m_queries[MMAP_MAX_QUERIES_PER_THREAD];
+            uint32 m_useCounter;
+    };
+
+    typedef ACE_Atomic_Op<ACE_Thread_Mutex, long> MMapCounter;
+
+    struct NavMeshQueryStats
+    {
+        NavMeshQueryStats() : pathSearches(0), nodeExhaustions(0), queriesCreated(0), queriesEvicted(0) {}
+
+        uint32 pathSearches;                // dtNavMeshQuery::findPath calls
+        uint32 nodeExhaustions;             // path searches that used all search nodes, their path may be incomplete
+        uint32 queriesCreated;              // queries allocated by the thread pools
+        uint32 queriesEvicted;              // queries switched to another map because the pool of their thread was full
+    };
+
     // singelton class
     // holds all all access to mmap loading unloading and meshes
     class MMapManager
@@ -73,23 +112,42 @@ namespace MMAP
             MMapManager() : loadedTiles(0) {}
             ~MMapManager();
 
-            bool loadMap(uint32 mapId, int32 x, int32 y);
+            // tileData read in advance by readTileData() is owned by the manager afterwards, the file is read if NULL
+            bool loadMap(uint32 mapId, int32 x, int32 y, unsigned char* tileData = NULL, uint32 tileDataSize = 0);
             bool unloadMap(uint32 mapId, int32 x, int32 y);
             bool unloadMap(uint32 mapId);
-            bool unloadMapInstance(uint32 mapId, uint32 instanceId);
 
-            // the returned [dtNavMeshQuery const*] is NOT threadsafe
-            dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
+            // the returned query belongs to the calling thread and must not be passed to another one
+            dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
 
+            // read locked while paths are built, tiles and meshes are only added and removed with the write lock
+            ACE_RW_Thread_Mutex& GetNavMeshLock() { return m_navMeshLock; }
+
+            // account a finished findPath of the query
+            void CountPathSearch(dtNavMeshQuery const* query);
+            NavMeshQueryStats GetQueryStats(bool reset);
+
             uint32 getLoadedTilesCount() const { return loadedTiles; }
             uint32 getLoadedMapsCount() const { return loadedMMaps.size(); }
+
+            // reads a mmtile file into a dtAlloc'ed buffer, uses no manager data and is safe to call from any thread
+            static unsigned char* readTileData(uint32 mapId, int32 x, int32 y, uint32& dataSize);
         private:
             bool loadMapData(uint32 mapId);
             uint32 packTileID(int32 x, int32 y);
 
             MMapDataSet loadedMMaps;
             uint32 loadedTiles;
+
+            ACE_RW_Thread_Mutex m_navMeshLock;              // taken before m_lock where both are needed
+            ACE_Thread_Mutex m_lock;                        // guards loadedMMaps, used by all threads looking up a query
+            ACE_TSS<NavMeshQueryPool> m_queryPools;
+
+            MMapCounter m_pathSearches;
+            MMapCounter m_nodeExhaustions;
+            MMapCounter m_queriesCreated;
+            MMapCounter m_queriesEvicted;
     };
 
     // static class
@@ -79,7 +79,7 @@ void Object::_InitValues()
     m_uint32Values = new uint32[ m_valuesCount ];
     memset(m_uint32Values, 0, m_valuesCount * sizeof(uint32));
 
-    m_changedValues.resize(m_valuesCount, false);
+    m_changedValues.SetCount(m_valuesCount);
 
     m_objectUpdated = false;
 }
@@ -210,16 +210,43 @@ void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) c
 {
     ByteBuffer buf(500);
 
-    buf << uint8(UPDATETYPE_VALUES);
-    buf << GetPackGUID();
+    BuildValuesUpdateBlock(&buf, target);
+
+    data->AddUpdateBlock(buf);
+}
+
+void Object::BuildValuesUpdateBlock(ByteBuffer* buf, Player* target) const
+{
+    *buf << uint8(UPDATETYPE_VALUES);
+    *buf << GetPackGUID();
 
     UpdateMask updateMask;
     updateMask.SetCount(m_valuesCount);
 
     _SetUpdateBits(&updateMask, target);
-    BuildValuesUpdate(UPDATETYPE_VALUES, &buf, &updateMask, target);
+    BuildValuesUpdate(UPDATETYPE_VALUES, buf, &updateMask, target);
+}
 
-    data->AddUpdateBlock(buf);
+// true if the values update block of the pending changes is the same for all observers except the object itself,
+// must be kept in sync with the target dependent cases of BuildValuesUpdate
+bool Object::IsValuesUpdateTargetIndependent() const
+{
+    if (isType(TYPEMASK_GAMEOBJECT))
+        return ((GameObject*)this)->IsTransport();          // GAMEOBJECT_DYNAMIC depends on quest state of target
+
+    if (isType(TYPEMASK_UNIT))
+    {
+        if (((Unit*)this)->HasAuraState(AURA_STATE_CONFLAGRATE))
+            return false;
+
+        if (m_changedValues.GetBit(UNIT_FIELD_FLAGS))              // not selectable flag is hidden for gamemasters
+            return false;
+
+        if (GetTypeId() == TYPEID_UNIT && (m_changedValues.GetBit(UNIT_NPC_FLAGS) || m_changedValues.GetBit(UNIT_DYNAMIC_FLAGS)))
+            return false;
+    }
+
+    return true;
 }
 
 void Object::BuildOutOfRangeUpdateBlock(UpdateData* data) const
@@ -454,162 +481,150 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
     MANGOS_ASSERT(updateMask && updateMask->GetCount() == m_valuesCount);
 
     *data << (uint8)updateMask->GetBlockCount();
-    data->append(updateMask->GetMask(), updateMask->GetLength());
+    for (uint32 block = 0; block < updateMask->GetBlockCount(); ++block)
+        *data << uint32(updateMask->GetBlock(block));
 
     // 2 specialized loops for speed optimization in non-unit case
     if (isType(TYPEMASK_UNIT))                              // unit (creature/player) case
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint16 index = updateMask->FindNextSetBit(0); index < m_valuesCount; index = updateMask->FindNextSetBit(index + 1))
         {
-            if (updateMask->GetBit(index))
+            if (index == UNIT_NPC_FLAGS)
             {
-                if (index == UNIT_NPC_FLAGS)
+                uint32 appendValue = m_uint32Values[index];
+
+                if (GetTypeId() == TYPEID_UNIT)
                 {
-                    uint32 appendValue = m_uint32Values[index];
+                    if (!target->canSeeSpellClickOn((Creature*)this))
+                        appendValue &= ~UNIT_NPC_FLAG_SPELLCLICK;
 
-                    if (GetTypeId() == TYPEID_UNIT)
+                    if (appendValue & UNIT_NPC_FLAG_TRAINER)
                     {
-                        if (!target->canSeeSpellClickOn((Creature*)this))
-                            appendValue &= ~UNIT_NPC_FLAG_SPELLCLICK;
-
-                        if (appendValue & UNIT_NPC_FLAG_TRAINER)
-                        {
-                            if (!((Creature*)this)->IsTrainerOf(target, false))
-                                appendValue &= ~(UNIT_NPC_FLAG_TRAINER | UNIT_NPC_FLAG_TRAINER_CLASS | UNIT_NPC_FLAG_TRAINER_PROFESSION);
-                        }
-
-                        if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
-                        {
-                            if (target->getClass() != CLASS_HUNTER)
-                                appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER;
-                        }
+                        if (!((Creature*)this)->IsTrainerOf(target, false))
+                            appendValue &= ~(UNIT_NPC_FLAG_TRAINER | UNIT_NPC_FLAG_TRAINER_CLASS | UNIT_NPC_FLAG_TRAINER_PROFESSION);
                     }
 
-                    *data << uint32(appendValue);
-                }
-                else if (index == UNIT_FIELD_AURASTATE)
-                {
-                    if (IsPerCasterAuraState)
+                    if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
                     {
-                        // IsPerCasterAuraState set if related pet caster aura state set already
-                        if (((Unit*)this)->HasAuraStateForCaster(AURA_STATE_CONFLAGRATE, target->GetObjectGuid()))
-                            *data << m_uint32Values[index];
-                        else
-                            *data << (m_uint32Values[index] & ~(1 << (AURA_STATE_CONFLAGRATE - 1)));
+                        if (target->getClass() != CLASS_HUNTER)
+                            appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER;
                     }
-                    else
-                        *data << m_uint32Values[index];
-                }
-                // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
-                else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
-                {
-                    // convert from float to uint32 and send
-                    *data << uint32(m_floatValues[index] < 0 ? 0 : m_floatValues[index]);
                 }
 
-                // there are some float values which may be negative or can't get negative due to other checks
-                else if ((index >= UNIT_FIELD_NEGSTAT0 && index <= UNIT_FIELD_NEGSTAT4) ||
-                         (index >= UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6)) ||
-                         (index >= UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6)) ||
-                         (index >= UNIT_FIELD_POSSTAT0 && index <= UNIT_FIELD_POSSTAT4))
-                {
-                    *data << uint32(m_floatValues[index]);
-                }
-
-                // Gamemasters should be always able to select units - remove not selectable flag
-                else if (index == UNIT_FIELD_FLAGS && target->isGameMaster())
-                {
-                    *data << (m_uint32Values[index] & ~UNIT_FLAG_NOT_SELECTABLE);
-                }
-                // hide lootable animation for unallowed players
-                else if (index == UNIT_DYNAMIC_FLAGS && GetTypeId() == TYPEID_UNIT)
+                *data << uint32(appendValue);
+            }
+            else if (index == UNIT_FIELD_AURASTATE)
+            {
+                if (IsPerCasterAuraState)
                 {
-                    if (!target->isAllowedToLoot((Creature*)this))
-                        *data << (m_uint32Values[index] & ~(UNIT_DYNFLAG_LOOTABLE | UNIT_DYNFLAG_TAPPED_BY_PLAYER));
+                    // IsPerCasterAuraState set if related pet caster aura state set already
+                    if (((Unit*)this)->HasAuraStateForCaster(AURA_STATE_CONFLAGRATE, target->GetObjectGuid()))
+                        *data << m_uint32Values[index];
                     else
-                    {
-                        // flag only for original loot recipent
-                        if (target->GetObjectGuid() == ((Creature*)this)->GetLootRecipientGuid())
-                            *data << m_uint32Values[index];
-                        else
-                            *data << (m_uint32Values[index] & ~(UNIT_DYNFLAG_TAPPED | UNIT_DYNFLAG_TAPPED_BY_PLAYER));
-                    }
+                        *data << (m_uint32Values[index] & ~(1 << (AURA_STATE_CONFLAGRATE - 1)));
                 }
                 else
-                {
-                    // send in current format (float as float, uint32 as uint32)
                     *data << m_uint32Values[index];
+            }
+            // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
+            else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
+            {
+                // convert from float to uint32 and send
+                *data << uint32(m_floatValues[index] < 0 ? 0 : m_floatValues[index]);
+            }
+
+            // there are some float values which may be negative or can't get negative due to other checks
+            else if ((index >= UNIT_FIELD_NEGSTAT0 && index <= UNIT_FIELD_NEGSTAT4) ||
+                     (index >= UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6)) ||
+                     (index >= UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6)) ||
+                     (index >= UNIT_FIELD_POSSTAT0 && index <= UNIT_FIELD_POSSTAT4))
+            {
+                *data << uint32(m_floatValues[index]);
+            }
+
+            // Gamemasters should be always able to select units - remove not selectable flag
+            else if (index == UNIT_FIELD_FLAGS && target->isGameMaster())
+            {
+                *data << (m_uint32Values[index] & ~UNIT_FLAG_NOT_SELECTABLE);
+            }
+            // hide lootable animation for unallowed players
+            else if (index == UNIT_DYNAMIC_FLAGS && GetTypeId() == TYPEID_UNIT)
+            {
+                if (!target->isAllowedToLoot((Creature*)this))
+                    *data << (m_uint32Values[index] & ~(UNIT_DYNFLAG_LOOTABLE | UNIT_DYNFLAG_TAPPED_BY_PLAYER));
+                else
+                {
+                    // flag only for original loot recipent
+                    if (target->GetObjectGuid() == ((Creature*)this)->GetLootRecipientGuid())
+                        *data << m_uint32Values[index];
+                    else
+                        *data << (m_uint32Values[index] & ~(UNIT_DYNFLAG_TAPPED | UNIT_DYNFLAG_TAPPED_BY_PLAYER));
                 }
             }
+            else
+            {
+                // send in current format (float as float, uint32 as uint32)
+                *data << m_uint32Values[index];
+            }
         }
     }
     else if (isType(TYPEMASK_GAMEOBJECT))                   // gameobject case
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint16 index = updateMask->FindNextSetBit(0); index < m_valuesCount; index = updateMask->FindNextSetBit(index + 1))
         {
-            if (updateMask->GetBit(index))
+            // send in current format (float as float, uint32 as uint32)
+            if (index == GAMEOBJECT_DYNAMIC)
             {
-                // send in current format (float as float, uint32 as uint32)
-                if (index == GAMEOBJECT_DYNAMIC)
-                {
-                    // GAMEOBJECT_TYPE_DUNGEON_DIFFICULTY can have lo flag = 2
-                    //      most likely related to "can enter map" and then should be 0 if can not enter
+                // GAMEOBJECT_TYPE_DUNGEON_DIFFICULTY can have lo flag = 2
+                //      most likely related to "can enter map" and then should be 0 if can not enter
 
-                    if (IsActivateToQuest)
-                    {
-                        switch (((GameObject*)this)->GetGoType())
-                        {
-                            case GAMEOBJECT_TYPE_QUESTGIVER:
-                                // GO also seen with GO_DYNFLAG_LO_SPARKLE explicit, relation/reason unclear (192861)
-                                *data << uint16(GO_DYNFLAG_LO_ACTIVATE);
-                                *data << uint16(-1);
-                                break;
-                            case GAMEOBJECT_TYPE_CHEST:
-                            case GAMEOBJECT_TYPE_GENERIC:
-                            case GAMEOBJECT_TYPE_SPELL_FOCUS:
-                            case GAMEOBJECT_TYPE_GOOBER:
-                                *data << uint16(GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE);
-                                *data << uint16(-1);
-                                break;
-                            default:
-                                // unknown, not happen.
-                                *data << uint16(0);
-                                *data << uint16(-1);
-                                break;
-                        }
-                    }
-                    else
+                if (IsActivateToQuest)
+                {
+                    switch (((GameObject*)this)->GetGoType())
                     {
-                        // disable quest object
-                        *data << uint16(0);
-                        *data << uint16(-1);
+                        case GAMEOBJECT_TYPE_QUESTGIVER:
+                            // GO also seen with GO_DYNFLAG_LO_SPARKLE explicit, relation/reason unclear (192861)
+                            *data << uint16(GO_DYNFLAG_LO_ACTIVATE);
+                            *data << uint16(-1);
+                            break;
+                        case GAMEOBJECT_TYPE_CHEST:
+                        case GAMEOBJECT_TYPE_GENERIC:
+                        case GAMEOBJECT_TYPE_SPELL_FOCUS:
+                        case GAMEOBJECT_TYPE_GOOBER:
+                            *data << uint16(GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE);
+                            *data << uint16(-1);
+                            break;
+                        default:
+                            // unknown, not happen.
+                            *data << uint16(0);
+                            *data << uint16(-1);
+                            break;
                     }
                 }
                 else
-                    *data << m_uint32Values[index];         // other cases
+                {
+                    // disable quest object
+                    *data << uint16(0);
+                    *data << uint16(-1);
+                }
             }
+            else
+                *data << m_uint32Values[index];             // other cases
         }
     }
     else                                                    // other objects case (no special index checks)
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint16 index = updateMask->FindNextSetBit(0); index < m_valuesCount; index = updateMask->FindNextSetBit(index + 1))
         {
-            if (updateMask->GetBit(index))
-            {
-                // send in current format (float as float, uint32 as uint32)
-                *data << m_uint32Values[index];
-            }
+            // send in current format (float as float, uint32 as uint32)
+            *data << m_uint32Values[index];
         }
     }
 }
 
 void Object::ClearUpdateMask(bool remove)
 {
-    if (m_uint32Values)
-    {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
-            m_changedValues[index] = false;
-    }
+    m_changedValues.Clear();
 
     if (m_objectUpdated)
     {
@@ -640,9 +655,7 @@ bool Object::LoadValues(const char* data)
 
 void Object::_SetUpdateBits(UpdateMask* updateMask, Player* /*target*/) const
 {
-    for (uint16 index = 0; index < m_valuesCount; ++index)
-        if (m_changedValues[index])
-            updateMask->SetBit(index);
+    *updateMask |= m_changedValues;
 }
 
 void Object::_SetCreateBits(UpdateMask* updateMask, Player* /*target*/) const
@@ -659,7 +672,7 @@ void Object::SetInt32Value(uint16 index, int32 value)
     if (m_int32Values[index] != value)
     {
         m_int32Values[index] = value;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -671,7 +684,7 @@ void Object::SetUInt32Value(uint16 index, uint32 value)
     if (m_uint32Values[index] != value)
     {
         m_uint32Values[index] = value;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -683,8 +696,8 @@ void Object::SetUInt64Value(uint16 index, const uint64& value)
     {
         m_uint32Values[index] = *((uint32*)&value);
         m_uint32Values[index + 1] = *(((uint32*)&value) + 1);
-        m_changedValues[index] = true;
-        m_changedValues[index + 1] = true;
+        m_changedValues.SetBit(index);
+        m_changedValues.SetBit(index + 1);
         MarkForClientUpdate();
     }
 }
@@ -696,7 +709,7 @@ void Object::SetFloatValue(uint16 index, float value)
     if (m_floatValues[index] != value)
     {
         m_floatValues[index] = value;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -715,7 +728,7 @@ void Object::SetByteValue(uint16 index, uint8 offset, uint8 value)
     {
         m_uint32Values[index] &= ~uint32(uint32(0xFF) << (offset * 8));
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 8));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -734,7 +747,7 @@ void Object::SetUInt16Value(uint16 index, uint8 offset, uint16 value)
     {
         m_uint32Values[index] &= ~uint32(uint32(0xFFFF) << (offset * 16));
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 16));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -796,7 +809,7 @@ void Object::SetFlag(uint16 index, uint32 newFlag)
     if (oldval != newval)
     {
         m_uint32Values[index] = newval;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -810,7 +823,7 @@ void Object::RemoveFlag(uint16 index, uint32 oldFlag)
     if (oldval != newval)
     {
         m_uint32Values[index] = newval;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -828,7 +841,7 @@ void Object::SetByteFlag(uint16 index, uint8 offset, uint8 newFlag)
     if (!(uint8(m_uint32Values[index] >> (offset * 8)) & newFlag))
     {
         m_uint32Values[index] |= uint32(uint32(newFlag) << (offset * 8));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -846,7 +859,7 @@ void Object::RemoveByteFlag(uint16 index, uint8 offset, uint8 oldFlag)
     if (uint8(m_uint32Values[index] >> (offset * 8)) & oldFlag)
     {
         m_uint32Values[index] &= ~uint32(uint32(oldFlag) << (offset * 8));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -858,7 +871,7 @@ void Object::SetShortFlag(uint16 index, bool highpart, uint16 newFlag)
     if (!(uint16(m_uint32Values[index] >> (highpart ? 16 : 0)) & newFlag))
     {
         m_uint32Values[index] |= uint32(uint32(newFlag) << (highpart ? 16 : 0));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -870,7 +883,7 @@ void Object::RemoveShortFlag(uint16 index, bool highpart, uint16 oldFlag)
     if (uint16(m_uint32Values[index] >> (highpart ? 16 : 0)) & oldFlag)
     {
         m_uint32Values[index] &= ~uint32(uint32(oldFlag) << (highpart ? 16 : 0));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -892,18 +905,15 @@ bool Object::PrintEntryError(char const* descr) const
 }
 
 
-void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players)
+void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, ByteBuffer const* sharedBlock /*= NULL*/)
 {
-    UpdateDataMapType::iterator iter = update_players.find(pl);
+    // constructed in place at first access, avoids copying a temporary UpdateData with preallocated storage
+    UpdateData& data = update_players[pl];
 
-    if (iter == update_players.end())
-    {
-        std::pair<UpdateDataMapType::iterator, bool> p = update_players.insert(UpdateDataMapType::value_type(pl, UpdateData()));
-        MANGOS_ASSERT(p.second);
-        iter = p.first;
-    }
-
-    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+    if (sharedBlock)
+        data.AddUpdateBlock(*sharedBlock);
+    else
+        BuildValuesUpdateBlockForPlayer(&data, pl);
 }
 
 void Object::AddToClientUpdateList()
@@ -1852,7 +1862,11 @@ struct WorldObjectChangeAccumulator
 {
     UpdateDataMapType& i_updateDatas;
     WorldObject& i_object;
-    WorldObjectChangeAccumulator(WorldObject& obj, UpdateDataMapType& d) : i_updateDatas(d), i_object(obj)
+    bool i_shareBlock;
+    ByteBuffer i_sharedBlock;                               // values block serialized once for all observers if possible
+
+    WorldObjectChangeAccumulator(WorldObject& obj, UpdateDataMapType& d) : i_updateDatas(d), i_object(obj),
+        i_shareBlock(obj.IsValuesUpdateTargetIndependent()), i_sharedBlock(i_shareBlock ? 500 : 0)
     {
         // send self fields changes in another way, otherwise
         // with new camera system when player's camera too far from player, camera wouldn't receive packets and changes from player
@@ -1866,7 +1880,18 @@ struct WorldObjectChangeAccumulator
         {
             Player* owner = iter->getSource()->GetOwner();
             if (owner != &i_object && owner->HaveAtClient(&i_object))
-                i_object.BuildUpdateDataForPlayer(owner, i_updateDatas);
+            {
+                if (!i_shareBlock)
+                {
+                    i_object.BuildUpdateDataForPlayer(owner, i_updateDatas);
+                    continue;
+                }
+
+                if (i_sharedBlock.empty())
+                    i_object.BuildValuesUpdateBlock(&i_sharedBlock, owner);
+
+                i_object.BuildUpdateDataForPlayer(owner, i_updateDatas, &i_sharedBlock);
+            }
         }
     }
 
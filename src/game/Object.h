@@ -23,6 +23,7 @@
 #include "ByteBuffer.h"
 #include "UpdateFields.h"
 #include "UpdateData.h"
+#include "UpdateMask.h"
 #include "ObjectGuid.h"
 #include "Camera.h"
 
@@ -70,7 +71,6 @@ class Player;
 class Unit;
 class Group;
 class Map;
-class UpdateMask;
 class InstanceData;
 class TerrainInfo;
 class TransportInfo;
@@ -170,6 +170,8 @@ class MANGOS_DLL_SPEC Object
         void SendForcedObjectUpdate();
 
         void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const;
+        void BuildValuesUpdateBlock(ByteBuffer* buf, Player* target) const;
+        bool IsValuesUpdateTargetIndependent() const;
         void BuildOutOfRangeUpdateBlock(UpdateData* data) const;
         void BuildMovementUpdateBlock(UpdateData* data, uint16 flags = 0) const;
 
@@ -371,7 +373,7 @@ class MANGOS_DLL_SPEC Object
 
         void BuildMovementUpdate(ByteBuffer* data, uint16 updateFlags) const;
         void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target) const;
-        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players);
+        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, ByteBuffer const* sharedBlock = NULL);
 
         uint16 m_objectType;
 
@@ -385,7 +387,7 @@ class MANGOS_DLL_SPEC Object
             float*  m_floatValues;
         };
 
-        std::vector<bool> m_changedValues;
+        UpdateMask m_changedValues;
 
         uint16 m_valuesCount;
 
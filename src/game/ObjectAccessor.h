@@ -51,6 +51,7 @@ class HashMapHolder
         typedef ACE_Read_Guard<LockType> ReadGuard;
         typedef ACE_Write_Guard<LockType> WriteGuard;
 
+        // also called by map workers, corpses are added and removed inside the map update
         static void Insert(T* o)
         {
             WriteGuard guard(i_lock);
@@ -23,6 +23,7 @@
 #include "SQLStorages.h"
 #include "Log.h"
 #include "MapManager.h"
+#include "MapUpdater.h"
 #include "ObjectGuid.h"
 #include "ScriptMgr.h"
 #include "SpellMgr.h"
@@ -226,6 +227,7 @@ ArenaTeam* ObjectMgr::GetArenaTeamByCaptain(ObjectGuid guid) const
 void ObjectMgr::LoadCreatureLocales()
 {
     mCreatureLocaleMap.clear();                             // need for reload case
+    m_queryResponseCache.Clear(QUERY_RESPONSE_CREATURE);    // responses contain the locale strings
 
     QueryResult* result = WorldDatabase.Query("SELECT entry,name_loc1,subname_loc1,name_loc2,subname_loc2,name_loc3,subname_loc3,name_loc4,subname_loc4,name_loc5,subname_loc5,name_loc6,subname_loc6,name_loc7,subname_loc7,name_loc8,subname_loc8 FROM locales_creature");
 
@@ -1627,23 +1629,25 @@ void ObjectMgr::RemoveGameobjectFromGrid(uint32 guid, GameObjectData const* data
     }
 }
 
+// key of m_characterGuidsByName, the characters table compares names case insensitive
+static std::string CharacterNameKey(std::string name)
+{
+    std::string key = name;
+    return normalizePlayerName(key) ? key : name;
+}
+
 // name must be checked to correctness (if received) before call this function
 ObjectGuid ObjectMgr::GetPlayerGuidByName(std::string name) const
 {
-    ObjectGuid guid;
-
-    CharacterDatabase.escape_string(name);
+    std::string key = CharacterNameKey(name);
 
-    // Player name safe to sending to DB (checked at login) and this function using
-    QueryResult* result = CharacterDatabase.PQuery("SELECT guid FROM characters WHERE name = '%s'", name.c_str());
-    if (result)
-    {
-        guid = ObjectGuid(HIGHGUID_PLAYER, (*result)[0].GetUInt32());
+    ACE_READ_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, m_characterNamesLock, ObjectGuid());
 
-        delete result;
-    }
+    CharacterGuidByNameMap::const_iterator itr = m_characterGuidsByName.find(key);
+    if (itr == m_characterGuidsByName.end())
+        return ObjectGuid();
 
-    return guid;
+    return ObjectGuid(HIGHGUID_PLAYER, itr->second);
 }
 
 bool ObjectMgr::GetPlayerNameByGUID(ObjectGuid guid, std::string& name) const
@@ -1655,18 +1659,12 @@ bool ObjectMgr::GetPlayerNameByGUID(ObjectGuid guid, std::string& name) const
         return true;
     }
 
-    uint32 lowguid = guid.GetCounter();
-
-    QueryResult* result = CharacterDatabase.PQuery("SELECT name FROM characters WHERE guid = '%u'", lowguid);
-
-    if (result)
-    {
-        name = (*result)[0].GetCppString();
-        delete result;
-        return true;
-    }
+    CharacterNameData data;
+    if (!GetCharacterNameData(guid.GetCounter(), data))
+        return false;
 
-    return false;
+    name = data.name;
+    return true;
 }
 
 Team ObjectMgr::GetPlayerTeamByGUID(ObjectGuid guid) const
@@ -1675,18 +1673,11 @@ Team ObjectMgr::GetPlayerTeamByGUID(ObjectGuid guid) const
     if (Player* player = GetPlayer(guid))
         return Player::TeamForRace(player->getRace());
 
-    uint32 lowguid = guid.GetCounter();
-
-    QueryResult* result = CharacterDatabase.PQuery("SELECT race FROM characters WHERE guid = '%u'", lowguid);
+    CharacterNameData data;
+    if (!GetCharacterNameData(guid.GetCounter(), data))
+        return TEAM_NONE;
 
-    if (result)
-    {
-        uint8 race = (*result)[0].GetUInt8();
-        delete result;
-        return Player::TeamForRace(race);
-    }
-
-    return TEAM_NONE;
+    return Player::TeamForRace(data.race);
 }
 
 uint32 ObjectMgr::GetPlayerAccountIdByGUID(ObjectGuid guid) const
@@ -1698,35 +1689,179 @@ uint32 ObjectMgr::GetPlayerAccountIdByGUID(ObjectGuid guid) const
     if (Player* player = GetPlayer(guid))
         return player->GetSession()->GetAccountId();
 
-    uint32 lowguid = guid.GetCounter();
+    CharacterNameData data;
+    if (!GetCharacterNameData(guid.GetCounter(), data))
+        return 0;
 
-    QueryResult* result = CharacterDatabase.PQuery("SELECT account FROM characters WHERE guid = '%u'", lowguid);
-    if (result)
+    return data.account;
+}
+
+uint32 ObjectMgr::GetPlayerAccountIdByPlayerName(const std::string& name) const
+{
+    ObjectGuid guid = GetPlayerGuidByName(name);
+    if (!guid)
+        return 0;
+
+    CharacterNameData data;
+    if (!GetCharacterNameData(guid.GetCounter(), data))
+        return 0;
+
+    return data.account;
+}
+
+bool ObjectMgr::GetCharacterNameData(uint32 lowguid, CharacterNameData& data) const
+{
+    ACE_READ_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, m_characterNamesLock, false);
+
+    CharacterNameDataMap::const_iterator itr = m_characterNames.find(lowguid);
+    if (itr == m_characterNames.end())
+        return false;
+
+    data = itr->second;
+    return true;
+}
+
+void ObjectMgr::SetCharacterNameData(uint32 lowguid, CharacterNameData const& data)
+{
+    ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, m_characterNamesLock);
+
+    CharacterNameData& current = m_characterNames[lowguid];
+    if (current.name != data.name)
     {
-        uint32 acc = (*result)[0].GetUInt32();
-        delete result;
-        return acc;
+        // the name may be owned by another character, see below
+        if (!current.name.empty())
+        {
+            CharacterGuidByNameMap::iterator itr = m_characterGuidsByName.find(CharacterNameKey(current.name));
+            if (itr != m_characterGuidsByName.end() && itr->second == lowguid)
+                m_characterGuidsByName.erase(itr);
+        }
+
+        // a loaded dump can keep the name of another character until it is renamed at login, the name stays with that character
+        if (!data.name.empty())
+            m_characterGuidsByName.insert(CharacterGuidByNameMap::value_type(CharacterNameKey(data.name), lowguid));
     }
 
-    return 0;
+    current = data;
 }
 
-uint32 ObjectMgr::GetPlayerAccountIdByPlayerName(const std::string& name) const
+void ObjectMgr::RemoveCharacterNameData(uint32 lowguid)
 {
-    QueryResult* result = CharacterDatabase.PQuery("SELECT account FROM characters WHERE name = '%s'", name.c_str());
-    if (result)
+    ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, m_characterNamesLock);
+
+    CharacterNameDataMap::iterator itr = m_characterNames.find(lowguid);
+    if (itr == m_characterNames.end())
+        return;
+
+    if (!itr->second.name.empty())
     {
-        uint32 acc = (*result)[0].GetUInt32();
-        delete result;
-        return acc;
+        CharacterGuidByNameMap::iterator nameItr = m_characterGuidsByName.find(CharacterNameKey(itr->second.name));
+        if (nameItr != m_characterGuidsByName.end() && nameItr->second == lowguid)
+            m_characterGuidsByName.erase(nameItr);
     }
 
-    return 0;
+    m_characterNames.erase(itr);
+    m_characterDeclinedNames.erase(lowguid);
+}
+
+bool ObjectMgr::GetCharacterDeclinedNames(uint32 lowguid, DeclinedName& names) const
+{
+    ACE_READ_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, m_characterNamesLock, false);
+
+    CharacterDeclinedNamesMap::const_iterator itr = m_characterDeclinedNames.find(lowguid);
+    if (itr == m_characterDeclinedNames.end())
+        return false;
+
+    names = itr->second;
+    return true;
+}
+
+void ObjectMgr::SetCharacterDeclinedNames(uint32 lowguid, DeclinedName const* names)
+{
+    if (names && !sWorld.getConfig(CONFIG_BOOL_DECLINED_NAMES_USED))
+        return;
+
+    ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, m_characterNamesLock);
+
+    if (names)
+        m_characterDeclinedNames[lowguid] = *names;
+    else
+        m_characterDeclinedNames.erase(lowguid);
+}
+
+void ObjectMgr::LoadCharacterNames()
+{
+    m_characterNames.clear();
+    m_characterGuidsByName.clear();
+    m_characterDeclinedNames.clear();
+
+    //                                                     0     1        2     3     4       5      6
+    QueryResult* result = CharacterDatabase.Query("SELECT guid, account, name, race, gender, class, level FROM characters");
+    if (!result)
+    {
+        BarGoLink bar(1);
+        bar.step();
+
+        sLog.outString();
+        sLog.outString(">> Loaded 0 character names");
+        return;
+    }
+
+    BarGoLink bar(result->GetRowCount());
+
+    do
+    {
+        bar.step();
+        Field* fields = result->Fetch();
+
+        uint32 lowguid = fields[0].GetUInt32();
+
+        CharacterNameData& data = m_characterNames[lowguid];
+        data.account = fields[1].GetUInt32();
+        data.name = fields[2].GetCppString();
+        data.race = fields[3].GetUInt8();
+        data.gender = fields[4].GetUInt8();
+        data.playerClass = fields[5].GetUInt8();
+        data.level = fields[6].GetUInt8();
+
+        if (!data.name.empty())
+            m_characterGuidsByName[CharacterNameKey(data.name)] = lowguid;
+    }
+    while (result->NextRow());
+
+    delete result;
+
+    if (sWorld.getConfig(CONFIG_BOOL_DECLINED_NAMES_USED))
+    {
+        //                                           0     1         2       3           4             5
+        result = CharacterDatabase.Query("SELECT guid, genitive, dative, accusative, instrumental, prepositional FROM character_declinedname");
+        if (result)
+        {
+            do
+            {
+                Field* fields = result->Fetch();
+
+                // if the first declined name is empty, the rest must be too
+                if (fields[1].GetCppString().empty())
+                    continue;
+
+                DeclinedName& names = m_characterDeclinedNames[fields[0].GetUInt32()];
+                for (int i = 0; i < MAX_DECLINED_NAME_CASES; ++i)
+                    names.name[i] = fields[i + 1].GetCppString();
+            }
+            while (result->NextRow());
+
+            delete result;
+        }
+    }
+
+    sLog.outString();
+    sLog.outString(">> Loaded %u character names, %u with declined names", uint32(m_characterNames.size()), uint32(m_characterDeclinedNames.size()));
 }
 
 void ObjectMgr::LoadItemLocales()
 {
     mItemLocaleMap.clear();                                 // need for reload case
+    m_queryResponseCache.Clear(QUERY_RESPONSE_ITEM);        // responses contain the locale strings
 
     QueryResult* result = WorldDatabase.Query("SELECT entry,name_loc1,description_loc1,name_loc2,description_loc2,name_loc3,description_loc3,name_loc4,description_loc4,name_loc5,description_loc5,name_loc6,description_loc6,name_loc7,description_loc7,name_loc8,description_loc8 FROM locales_item");
 
@@ -5867,6 +6002,7 @@ void ObjectMgr::SetHighestGuids()
 void ObjectMgr::LoadGameObjectLocales()
 {
     mGameObjectLocaleMap.clear();                           // need for reload case
+    m_queryResponseCache.Clear(QUERY_RESPONSE_GAMEOBJECT);  // responses contain the locale strings
 
     QueryResult* result = WorldDatabase.Query("SELECT entry,"
                           "name_loc1,name_loc2,name_loc3,name_loc4,name_loc5,name_loc6,name_loc7,name_loc8,"
@@ -9479,21 +9615,29 @@ bool ObjectMgr::IsVendorItemValid(bool isTemplate, char const* tableName, uint32
 
 void ObjectMgr::AddGroup(Group* group)
 {
+    MANGOS_ASSERT_NOT_MAP_WORKER();
+
     mGroupMap[group->GetId()] = group ;
 }
 
 void ObjectMgr::RemoveGroup(Group* group)
 {
+    MANGOS_ASSERT_NOT_MAP_WORKER();
+
     mGroupMap.erase(group->GetId());
 }
 
 void ObjectMgr::AddArenaTeam(ArenaTeam* arenaTeam)
 {
+    MANGOS_ASSERT_NOT_MAP_WORKER();
+
     mArenaTeamMap[arenaTeam->GetId()] = arenaTeam;
 }
 
 void ObjectMgr::RemoveArenaTeam(uint32 Id)
 {
+    MANGOS_ASSERT_NOT_MAP_WORKER();
+
     mArenaTeamMap.erase(Id);
 }
 
@@ -35,7 +35,9 @@
 #include "MapPersistentStateMgr.h"
 #include "ObjectAccessor.h"
 #include "ObjectGuid.h"
+#include "QueryResponseCache.h"
 #include "Policies/Singleton.h"
+#include "ace/RW_Thread_Mutex.h"
 
 #include <string>
 #include <map>
@@ -451,6 +453,19 @@ typedef UNORDERED_MAP<uint32, uint32> CacheNpcTextIdMap;
 typedef UNORDERED_MAP<uint32, VendorItemData> CacheVendorItemMap;
 typedef UNORDERED_MAP<uint32, TrainerSpellData> CacheTrainerSpellMap;
 
+// what other players need to know of a character, online or not
+struct CharacterNameData
+{
+    CharacterNameData() : account(0), race(0), gender(0), playerClass(0), level(0) {}
+
+    std::string name;                                       // empty for characters deleted by unlinking them from their account
+    uint32 account;
+    uint8 race;
+    uint8 gender;
+    uint8 playerClass;
+    uint8 level;                                            // as of the last save
+};
+
 enum SkillRangeType
 {
     SKILL_RANGE_LANGUAGE,                                   // 300..300
@@ -569,6 +584,14 @@ class ObjectMgr
         uint32 GetPlayerAccountIdByGUID(ObjectGuid guid) const;
         uint32 GetPlayerAccountIdByPlayerName(const std::string& name) const;
 
+        // the character name data is kept for all characters, changes to the characters table must be applied here as well
+        bool GetCharacterNameData(uint32 lowguid, CharacterNameData& data) const;
+        void SetCharacterNameData(uint32 lowguid, CharacterNameData const& data);
+        void RemoveCharacterNameData(uint32 lowguid);
+        // declined names are only kept if they are used, NULL removes them
+        bool GetCharacterDeclinedNames(uint32 lowguid, DeclinedName& names) const;
+        void SetCharacterDeclinedNames(uint32 lowguid, DeclinedName const* names);
+
         uint32 GetNearestTaxiNode(float x, float y, float z, uint32 mapid, Team team);
         void GetTaxiPath(uint32 source, uint32 destination, uint32& path, uint32& cost);
         uint32 GetTaxiMountDisplayId(uint32 id, Team team, bool allowed_alt_team = false);
@@ -730,6 +753,7 @@ class ObjectMgr
         void LoadPetNames();
         void LoadPetNumber();
         void LoadCorpses();
+        void LoadCharacterNames();
         void LoadFishingBaseSkillLevel();
 
         void LoadReputationRewardRate();
@@ -780,19 +804,20 @@ class ObjectMgr
         uint32 GenerateStaticCreatureLowGuid() { if (m_StaticCreatureGuids.GetNextAfterMaxUsed() >= m_FirstTemporaryCreatureGuid) return 0; return m_StaticCreatureGuids.Generate(); }
         uint32 GenerateStaticGameObjectLowGuid() { if (m_StaticGameObjectGuids.GetNextAfterMaxUsed() >= m_FirstTemporaryGameObjectGuid) return 0; return m_StaticGameObjectGuids.Generate(); }
 
-        uint32 GeneratePlayerLowGuid()   { return m_CharGuids.Generate();     }
-        uint32 GenerateItemLowGuid()     { return m_ItemGuids.Generate();     }
-        uint32 GenerateCorpseLowGuid()   { return m_CorpseGuids.Generate();   }
-        uint32 GenerateInstanceLowGuid() { return m_InstanceGuids.Generate(); }
-        uint32 GenerateGroupLowGuid()    { return m_GroupGuids.Generate();    }
-
-        uint32 GenerateArenaTeamId() { return m_ArenaTeamIds.Generate(); }
-        uint32 GenerateAuctionID() { return m_AuctionIds.Generate(); }
-        uint64 GenerateEquipmentSetGuid() { return m_EquipmentSetIds.Generate(); }
-        uint32 GenerateGuildId() { return m_GuildIds.Generate(); }
+        // guid and id generators are shared by all maps and can be called from parallel map updates
+        uint32 GeneratePlayerLowGuid()   { GuidGeneratorGuard guard(m_GuidGeneratorLock); return m_CharGuids.Generate();     }
+        uint32 GenerateItemLowGuid()     { GuidGeneratorGuard guard(m_GuidGeneratorLock); return m_ItemGuids.Generate();     }
+        uint32 GenerateCorpseLowGuid()   { GuidGeneratorGuard guard(m_GuidGeneratorLock); return m_CorpseGuids.Generate();   }
+        uint32 GenerateInstanceLowGuid() { GuidGeneratorGuard guard(m_GuidGeneratorLock); return m_InstanceGuids.Generate(); }
+        uint32 GenerateGroupLowGuid()    { GuidGeneratorGuard guard(m_GuidGeneratorLock); return m_GroupGuids.Generate();    }
+
+        uint32 GenerateArenaTeamId() { GuidGeneratorGuard guard(m_GuidGeneratorLock); return m_ArenaTeamIds.Generate(); }
+        uint32 GenerateAuctionID() { GuidGeneratorGuard guard(m_GuidGeneratorLock); return m_AuctionIds.Generate(); }
+        uint64 GenerateEquipmentSetGuid() { GuidGeneratorGuard guard(m_GuidGeneratorLock); return m_EquipmentSetIds.Generate(); }
+        uint32 GenerateGuildId() { GuidGeneratorGuard guard(m_GuidGeneratorLock); return m_GuildIds.Generate(); }
         // uint32 GenerateItemTextID() { return m_ItemGuids.Generate(); }
-        uint32 GenerateMailID() { return m_MailIds.Generate(); }
-        uint32 GeneratePetNumber() { return m_PetNumbers.Generate(); }
+        uint32 GenerateMailID() { GuidGeneratorGuard guard(m_GuidGeneratorLock); return m_MailIds.Generate(); }
+        uint32 GeneratePetNumber() { GuidGeneratorGuard guard(m_GuidGeneratorLock); return m_PetNumbers.Generate(); }
 
         MailLevelReward const* GetMailLevelReward(uint32 level, uint32 raceMask)
         {
@@ -865,6 +890,8 @@ class ObjectMgr
 
         void GetItemLocaleStrings(uint32 entry, int32 loc_idx, std::string* namePtr, std::string* descriptionPtr = NULL) const;
 
+        QueryResponseCache& GetQueryResponseCache() { return m_queryResponseCache; }
+
         QuestLocale const* GetQuestLocale(uint32 entry) const
         {
             QuestLocaleMap::const_iterator itr = mQuestLocaleMap.find(entry);
@@ -1123,6 +1150,10 @@ class ObjectMgr
         IdGenerator<uint32> m_MailIds;
         IdGenerator<uint32> m_PetNumbers;
 
+        typedef ACE_Thread_Mutex GuidGeneratorLock;
+        typedef ACE_Guard<GuidGeneratorLock> GuidGeneratorGuard;
+        GuidGeneratorLock m_GuidGeneratorLock;
+
         // initial free low guid for selected guid type for map local guids
         uint32 m_FirstTemporaryCreatureGuid;
         uint32 m_FirstTemporaryGameObjectGuid;
@@ -1173,6 +1204,15 @@ class ObjectMgr
         typedef std::set<std::wstring> ReservedNamesMap;
         ReservedNamesMap    m_ReservedNames;
 
+        // names of all characters, used by the map threads too
+        typedef UNORDERED_MAP<uint32, CharacterNameData> CharacterNameDataMap;
+        typedef UNORDERED_MAP<std::string, uint32> CharacterGuidByNameMap;
+        typedef UNORDERED_MAP<uint32, DeclinedName> CharacterDeclinedNamesMap;
+        mutable ACE_RW_Thread_Mutex m_characterNamesLock;
+        CharacterNameDataMap m_characterNames;
+        CharacterGuidByNameMap m_characterGuidsByName;      // by normalized name
+        CharacterDeclinedNamesMap m_characterDeclinedNames;
+
         GraveYardMap        mGraveYardMap;
 
         GameTeleMap         m_GameTeleMap;
@@ -1238,6 +1278,7 @@ class ObjectMgr
         QuestLocaleMap mQuestLocaleMap;
         NpcTextLocaleMap mNpcTextLocaleMap;
         PageTextLocaleMap mPageTextLocaleMap;
+        QueryResponseCache m_queryResponseCache;
         MangosStringLocaleMap mMangosStringLocaleMap;
         std::map<int32 /*minEntryOfBracket*/, uint32 /*count*/> m_loadedStringCount;
         GossipMenuItemsLocaleMap mGossipMenuItemsLocaleMap;
@@ -0,0 +1,148 @@
+/**
+ * This code is part of MaNGOS. Contributor & Copyright details are in AUTHORS/THANKS.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "OpcodeProfiler.h"
+#include "Policies/Singleton.h"
+
+#include <algorithm>
+
+INSTANTIATE_SINGLETON_1(OpcodeProfiler);
+
+static uint32 const bucketLimits[OPCODE_PROFILE_BUCKETS] = { 50, 100, 250, 500, 1000, 2500, 10000, 50000, 0 };
+
+static bool SortByTotalTime(OpcodeProfile const& left, OpcodeProfile const& right)
+{
+    return left.totalTime > right.totalTime;
+}
+
+OpcodeProfiler::OpcodeProfiler() : m_active(false), m_startTime(0), m_duration(0)
+{
+}
+
+void OpcodeProfiler::Start()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    if (m_active)
+        return;
+
+    m_startTime = time(NULL);
+    m_active = true;
+}
+
+void OpcodeProfiler::Stop()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    if (!m_active)
+        return;
+
+    m_duration += uint32(time(NULL) - m_startTime);
+    m_active = false;
+}
+
+void OpcodeProfiler::Reset()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+        m_profiles[i] = OpcodeProfile();
+
+    m_startTime = time(NULL);
+    m_duration = 0;
+}
+
+void OpcodeProfiler::AddSample(uint16 opcode, uint32 time, size_t bytes)
+{
+    if (opcode >= NUM_MSG_TYPES)
+        return;
+
+    uint32 bucket = 0;
+    while (bucket < OPCODE_PROFILE_BUCKETS - 1 && time > bucketLimits[bucket])
+        ++bucket;
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    OpcodeProfile& profile = m_profiles[opcode];
+    ++profile.count;
+    profile.totalTime += time;
+    profile.bytes += bytes;
+    if (time > profile.maxTime)
+        profile.maxTime = time;
+    ++profile.buckets[bucket];
+}
+
+OpcodeProfileList OpcodeProfiler::GetProfiles()
+{
+    OpcodeProfileList profiles;
+
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, profiles);
+
+        for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+        {
+            if (!m_profiles[i].count)
+                continue;
+
+            profiles.push_back(m_profiles[i]);
+            profiles.back().opcode = uint16(i);
+        }
+    }
+
+    std::sort(profiles.begin(), profiles.end(), SortByTotalTime);
+    return profiles;
+}
+
+uint32 OpcodeProfiler::GetDuration()
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, 0);
+
+    return m_active ? m_duration + uint32(time(NULL) - m_startTime) : m_duration;
+}
+
+bool OpcodeProfiler::Dump(std::string const& fileName)
+{
+    FILE* file = fopen(fileName.c_str(), "w");
+    if (!file)
+        return false;
+
+    OpcodeProfileList profiles = GetProfiles();
+
+    fprintf(file, "# opcode handler times over %u seconds, in microseconds\n", GetDuration());
+    fprintf(file, "opcode,name,count,total,average,max,bytes");
+    for (uint32 i = 0; i < OPCODE_PROFILE_BUCKETS; ++i)
+    {
+        if (bucketLimits[i])
+            fprintf(file, ",<=%u", bucketLimits[i]);
+        else
+            fprintf(file, ",>%u", bucketLimits[i - 1]);
+    }
+    fprintf(file, "\n");
+
+    for (OpcodeProfileList::const_iterator itr = profiles.begin(); itr != profiles.end(); ++itr)
+    {
+        fprintf(file, "0x%.4X,%s,%u," UI64FMTD "," UI64FMTD ",%u," UI64FMTD, itr->opcode, LookupOpcodeName(itr->opcode),
+                itr->count, itr->totalTime, itr->totalTime / itr->count, itr->maxTime, itr->bytes);
+        for (uint32 i = 0; i < OPCODE_PROFILE_BUCKETS; ++i)
+            fprintf(file, ",%u", itr->buckets[i]);
+        fprintf(file, "\n");
+    }
+
+    fclose(file);
+    return true;
+}
@@ -0,0 +1,88 @@
+/**
+ * This code is part of MaNGOS. Contributor & Copyright details are in AUTHORS/THANKS.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_OPCODEPROFILER_H
+#define MANGOS_OPCODEPROFILER_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "Opcodes.h"
+#include "ace/Thread_Mutex.h"
+
+#include <vector>
+
+// handler times are counted in these buckets, upper bounds in microseconds, the last one is open
+#define OPCODE_PROFILE_BUCKETS      9
+
+struct OpcodeProfile
+{
+    OpcodeProfile() : opcode(0), count(0), totalTime(0), maxTime(0), bytes(0)
+    {
+        memset(buckets, 0, sizeof(buckets));
+    }
+
+    uint16 opcode;
+    uint32 count;                                           ///< handled packets
+    uint64 totalTime;                                       ///< time spent in the handler, in microseconds
+    uint32 maxTime;
+    uint64 bytes;                                           ///< size of the handled packets
+    uint32 buckets[OPCODE_PROFILE_BUCKETS];
+};
+
+typedef std::vector<OpcodeProfile> OpcodeProfileList;
+
+/**
+ * Time spent by the opcode handlers, collected while enabled by .server opcodes on.
+ *
+ * Sessions are updated by several map threads at once, the samples are added under a lock.
+ * While disabled the only cost is checking IsActive() once per packet.
+ */
+class OpcodeProfiler
+{
+    public:
+        OpcodeProfiler();
+
+        void Start();
+        void Stop();
+        bool IsActive() const { return m_active; }
+
+        void Reset();
+
+        void AddSample(uint16 opcode, uint32 time, size_t bytes);
+
+        // profiles of all handled opcodes, most total time first
+        OpcodeProfileList GetProfiles();
+
+        // seconds the data was collected for
+        uint32 GetDuration();
+
+        // writes the profiles as CSV, returns false if the file can't be written
+        bool Dump(std::string const& fileName);
+
+    private:
+        volatile bool m_active;
+
+        ACE_Thread_Mutex m_lock;
+        OpcodeProfile m_profiles[NUM_MSG_TYPES];
+        time_t m_startTime;                                 ///< when the collecting was started, 0 if not yet
+        uint32 m_duration;                                  ///< seconds collected before the last start
+};
+
+#define sOpcodeProfiler MaNGOS::Singleton<OpcodeProfiler>::Instance()
+
+#endif
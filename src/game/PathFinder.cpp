@@ -20,6 +20,7 @@
 #include "GridMap.h"
 #include "Creature.h"
 #include "PathFinder.h"
+#include "PathRequestService.h"
 #include "Log.h"
 
 #include "../recastnavigation/Detour/Include/DetourCommon.h"
@@ -28,29 +29,30 @@
 PathFinder::PathFinder(const Unit* owner) :
     m_polyLength(0), m_type(PATHFIND_BLANK),
     m_useStraightPath(false), m_forceDestination(false), m_pointPathLimit(MAX_POINT_PATH_LENGTH),
-    m_sourceUnit(owner), m_navMesh(NULL), m_navMeshQuery(NULL)
+    m_sourceUnit(owner), m_sourceGuidLow(owner->GetGUIDLow()), m_mapId(owner->GetMapId()),
+    m_isCreature(false), m_canSwim(false), m_canFly(false), m_ignorePathfinding(false),
+    m_startUnderWater(false), m_endUnderWater(false),
+    m_navMesh(NULL), m_navMeshQuery(NULL), m_corridorCache(NULL)
 {
-    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathInfo for %u \n", m_sourceUnit->GetGUIDLow());
-
-    uint32 mapId = m_sourceUnit->GetMapId();
-    if (MMAP::MMapFactory::IsPathfindingEnabled(mapId))
-    {
-        MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
-        m_navMesh = mmap->GetNavMesh(mapId);
-        m_navMeshQuery = mmap->GetNavMeshQuery(mapId, m_sourceUnit->GetInstanceId());
-    }
+    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathInfo for %u \n", m_sourceGuidLow);
 
     createFilter();
 }
 
 PathFinder::~PathFinder()
 {
-    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::~PathInfo() for %u \n", m_sourceUnit->GetGUIDLow());
+    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::~PathInfo() for %u \n", m_sourceGuidLow);
 }
 
 bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest)
 {
-    Vector3 oldDest = getEndPosition();
+    prepare(destX, destY, destZ, forceDest);
+    build();
+    return true;
+}
+
+void PathFinder::prepare(float destX, float destY, float destZ, bool forceDest)
+{
     Vector3 dest(destX, destY, destZ);
     setEndPosition(dest);
 
@@ -61,22 +63,72 @@ bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest
 
     m_forceDestination = forceDest;
 
-    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::calculate() for %u \n", m_sourceUnit->GetGUIDLow());
+    // everything build() needs to know about the owner, it must not touch the unit
+    m_mapId = m_sourceUnit->GetMapId();
+    m_isCreature = m_sourceUnit->GetTypeId() == TYPEID_UNIT;
+    m_canSwim = m_isCreature && ((Creature*)m_sourceUnit)->CanSwim();
+    m_canFly = m_isCreature && ((Creature*)m_sourceUnit)->CanFly();
+    m_ignorePathfinding = m_sourceUnit->hasUnitState(UNIT_STAT_IGNORE_PATHFINDING);
+
+    // build() can't read the terrain, its grids may be unloaded meanwhile
+    // the water only decides between a swimming and a flying shortcut, so it is not needed if both or none are allowed
+    m_startUnderWater = false;
+    m_endUnderWater = false;
+    if (m_canSwim != m_canFly)
+    {
+        TerrainInfo const* terrain = m_sourceUnit->GetTerrain();
+        m_startUnderWater = terrain->IsUnderWater(x, y, z);
+        m_endUnderWater = terrain->IsUnderWater(destX, destY, destZ);
+    }
+
+    updateFilter();
+}
+
+void PathFinder::build(PathCorridorCache* corridorCache)
+{
+    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::build() for %u \n", m_sourceGuidLow);
+
+    Vector3 start = getStartPosition();
+    Vector3 dest = getEndPosition();
+
+    MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
+
+    // tiles are not added or removed while the path is built
+    ACE_READ_GUARD(ACE_RW_Thread_Mutex, guard, mmap->GetNavMeshLock());
+
+    // queries are owned by the calculating thread, take the one of the current thread every time
+    m_navMesh = MMAP::MMapFactory::IsPathfindingEnabled(m_mapId) ? mmap->GetNavMesh(m_mapId) : NULL;
+    m_navMeshQuery = m_navMesh ? mmap->GetNavMeshQuery(m_mapId) : NULL;
+    m_corridorCache = corridorCache;
 
     // make sure navMesh works - we can run on map w/o mmap
     // check if the start and end point have a .mmtile loaded (can we pass via not loaded tile on the way?)
-    if (!m_navMesh || !m_navMeshQuery || m_sourceUnit->hasUnitState(UNIT_STAT_IGNORE_PATHFINDING) ||
+    if (!m_navMesh || !m_navMeshQuery || m_ignorePathfinding ||
             !HaveTile(start) || !HaveTile(dest))
     {
         BuildShortcut();
         m_type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
-        return true;
     }
+    else
+        BuildPolyPath(start, dest);
 
-    updateFilter();
+    // the mesh and query are only valid while the lock is held
+    m_navMesh = NULL;
+    m_navMeshQuery = NULL;
+    m_corridorCache = NULL;
+}
 
-    BuildPolyPath(start, dest);
-    return true;
+void PathFinder::copyResult(PathFinder const& other)
+{
+    memcpy(m_pathPolyRefs, other.m_pathPolyRefs, other.m_polyLength * sizeof(dtPolyRef));
+    m_polyLength = other.m_polyLength;
+    m_pathPoints = other.m_pathPoints;
+    m_type = other.m_type;
+    m_actualEndPosition = other.m_actualEndPosition;
+
+    // the other path started at almost the same position, start at the own one
+    if (!m_pathPoints.empty())
+        m_pathPoints[0] = getStartPosition();
 }
 
 dtPolyRef PathFinder::getPathPolyByPosition(const dtPolyRef* polyPath, uint32 polyPathSize, const float* point, float* distance) const
@@ -165,14 +217,14 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: (startPoly == 0 || endPoly == 0)\n");
         BuildShortcut();
 
-        if (m_sourceUnit->GetTypeId() == TYPEID_UNIT)
+        if (m_isCreature)
         {
             // Check for swimming or flying shortcut
-            if ((startPoly == INVALID_POLYREF && m_sourceUnit->GetTerrain()->IsUnderWater(startPos.x, startPos.y, startPos.z)) ||
-                    (endPoly == INVALID_POLYREF && m_sourceUnit->GetTerrain()->IsUnderWater(endPos.x, endPos.y, endPos.z)))
-                m_type = ((Creature*)m_sourceUnit)->CanSwim() ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
+            if ((startPoly == INVALID_POLYREF && m_startUnderWater) ||
+                    (endPoly == INVALID_POLYREF && m_endUnderWater))
+                m_type = m_canSwim ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
             else
-                m_type = ((Creature*)m_sourceUnit)->CanFly() ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
+                m_type = m_canFly ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
         }
         else
             m_type = PATHFIND_NOPATH;
@@ -187,21 +239,18 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: farFromPoly distToStartPoly=%.3f distToEndPoly=%.3f\n", distToStartPoly, distToEndPoly);
 
         bool buildShotrcut = false;
-        if (m_sourceUnit->GetTypeId() == TYPEID_UNIT)
+        if (m_isCreature)
         {
-            Creature* owner = (Creature*)m_sourceUnit;
-
-            Vector3 p = (distToStartPoly > 7.0f) ? startPos : endPos;
-            if (m_sourceUnit->GetTerrain()->IsUnderWater(p.x, p.y, p.z))
+            if ((distToStartPoly > 7.0f) ? m_startUnderWater : m_endUnderWater)
             {
                 DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: underWater case\n");
-                if (owner->CanSwim())
+                if (m_canSwim)
                     buildShotrcut = true;
             }
             else
             {
                 DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: flying case\n");
-                if (owner->CanFly())
+                if (m_canFly)
                     buildShotrcut = true;
             }
         }
@@ -255,7 +304,9 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         for (pathStartIndex = 0; pathStartIndex < m_polyLength; ++pathStartIndex)
         {
             // here to catch few bugs
-            MANGOS_ASSERT(m_pathPolyRefs[pathStartIndex] != INVALID_POLYREF || m_sourceUnit->PrintEntryError("PathFinder::BuildPolyPath"));
+            if (m_pathPolyRefs[pathStartIndex] == INVALID_POLYREF)
+                sLog.outError("PathFinder::BuildPolyPath: invalid polygon in the path of %u", m_sourceGuidLow);
+            MANGOS_ASSERT(m_pathPolyRefs[pathStartIndex] != INVALID_POLYREF);
 
             if (m_pathPolyRefs[pathStartIndex] == startPoly)
             {
@@ -332,13 +383,14 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
                                 m_pathPolyRefs + prefixPolyLength - 1,    // [out] path
                                 (int*)&suffixPolyLength,
                                 MAX_PATH_LENGTH - prefixPolyLength); // max number of polygons in output path
+        MMAP::MMapFactory::createOrGetMMapManager()->CountPathSearch(m_navMeshQuery);
 
         if (!suffixPolyLength || dtResult != DT_SUCCESS)
         {
             // this is probably an error state, but we'll leave it
             // and hopefully recover on the next Update
             // we still need to copy our preffix
-            sLog.outError("%u's Path Build failed: 0 length path", m_sourceUnit->GetGUIDLow());
+            sLog.outError("%u's Path Build failed: 0 length path", m_sourceGuidLow);
         }
 
         DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++  m_polyLength=%u prefixPolyLength=%u suffixPolyLength=%u \n", m_polyLength, prefixPolyLength, suffixPolyLength);
@@ -357,23 +409,31 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         // free and invalidate old path data
         clear();
 
-        dtStatus dtResult = m_navMeshQuery->findPath(
-                                startPoly,          // start polygon
-                                endPoly,            // end polygon
-                                startPoint,         // start position
-                                endPoint,           // end position
-                                &m_filter,           // polygon search filter
-                                m_pathPolyRefs,     // [out] path
-                                (int*)&m_polyLength,
-                                MAX_PATH_LENGTH);   // max number of polygons in output path
-
-        if (!m_polyLength || dtResult != DT_SUCCESS)
+        // the same corridor may have been searched for another unit a moment ago
+        if (!m_corridorCache || !m_corridorCache->Find(m_mapId, startPoly, endPoly, m_filter, m_pathPolyRefs, m_polyLength, MAX_PATH_LENGTH))
         {
-            // only happens if we passed bad data to findPath(), or navmesh is messed up
-            sLog.outError("%u's Path Build failed: 0 length path", m_sourceUnit->GetGUIDLow());
-            BuildShortcut();
-            m_type = PATHFIND_NOPATH;
-            return;
+            dtStatus dtResult = m_navMeshQuery->findPath(
+                                    startPoly,          // start polygon
+                                    endPoly,            // end polygon
+                                    startPoint,         // start position
+                                    endPoint,           // end position
+                                    &m_filter,           // polygon search filter
+                                    m_pathPolyRefs,     // [out] path
+                                    (int*)&m_polyLength,
+                                    MAX_PATH_LENGTH);   // max number of polygons in output path
+            MMAP::MMapFactory::createOrGetMMapManager()->CountPathSearch(m_navMeshQuery);
+
+            if (!m_polyLength || dtResult != DT_SUCCESS)
+            {
+                // only happens if we passed bad data to findPath(), or navmesh is messed up
+                sLog.outError("%u's Path Build failed: 0 length path", m_sourceGuidLow);
+                BuildShortcut();
+                m_type = PATHFIND_NOPATH;
+                return;
+            }
+
+            if (m_corridorCache && m_pathPolyRefs[m_polyLength - 1] == endPoly)
+                m_corridorCache->Store(m_mapId, startPoly, endPoly, m_filter, m_pathPolyRefs, m_polyLength);
         }
     }
 
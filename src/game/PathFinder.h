@@ -29,6 +29,7 @@ using Movement::Vector3;
 using Movement::PointsArray;
 
 class Unit;
+class PathCorridorCache;
 
 // 74*4.0f=296y  number_of_points*interval = max_path_len
 // this is way more than actual evade range
@@ -62,6 +63,14 @@ class PathFinder
         // return: true if new path was calculated, false otherwise (no change needed)
         bool calculate(float destX, float destY, float destZ, bool forceDest = false);
 
+        // calculate() split in two steps: prepare() reads everything needed from the owner and must be
+        // called in its map thread, build() does not touch the owner or its terrain and may run in any thread
+        void prepare(float destX, float destY, float destZ, bool forceDest = false);
+        void build(PathCorridorCache* corridorCache = NULL);
+
+        // take over the result of another path built for (almost) the same start and end
+        void copyResult(PathFinder const& other);
+
         // option setters - use optional
         void setUseStrightPath(bool useStraightPath) { m_useStraightPath = useStraightPath; };
         void setPathLengthLimit(float distance) { m_pointPathLimit = std::min<uint32>(uint32(distance / SMOOTH_PATH_STEP_SIZE), MAX_POINT_PATH_LENGTH); };
@@ -74,6 +83,13 @@ class PathFinder
         PointsArray& getPath() { return m_pathPoints; }
         PathType getPathType() const { return m_type; }
 
+        // owner data taken by prepare()
+        uint32 getMapId() const { return m_mapId; }
+        const dtQueryFilter& getFilter() const { return m_filter; }
+        bool isForcedDestination() const { return m_forceDestination; }
+        bool isStraightPath() const { return m_useStraightPath; }
+        uint32 getPathLengthLimit() const { return m_pointPathLimit; }
+
     private:
 
         dtPolyRef      m_pathPolyRefs[MAX_PATH_LENGTH];   // array of detour polygon references
@@ -90,9 +106,21 @@ class PathFinder
         Vector3        m_endPosition;      // {x, y, z} of the destination
         Vector3        m_actualEndPosition;// {x, y, z} of the closest possible point to given destination
 
-        const Unit* const       m_sourceUnit;       // the unit that is moving
-        const dtNavMesh*        m_navMesh;          // the nav mesh
-        const dtNavMeshQuery*   m_navMeshQuery;     // the nav mesh query used to find the path
+        const Unit* const       m_sourceUnit;       // the unit that is moving, only used by prepare()
+        uint32                  m_sourceGuidLow;
+
+        // owner data taken by prepare()
+        uint32                  m_mapId;
+        bool                    m_isCreature;
+        bool                    m_canSwim;
+        bool                    m_canFly;
+        bool                    m_ignorePathfinding;
+        bool                    m_startUnderWater;  // only checked if the owner can either swim or fly
+        bool                    m_endUnderWater;
+
+        const dtNavMesh*        m_navMesh;          // the nav mesh, only set while building
+        const dtNavMeshQuery*   m_navMeshQuery;     // the nav mesh query used to find the path, only set while building
+        PathCorridorCache*      m_corridorCache;    // corridors searched by other paths, only set while building
 
         dtQueryFilter m_filter;                     // use single filter for all movements, update it when needed
 
@@ -0,0 +1,386 @@
+/**
+ * This code is part of MaNGOS. Contributor & Copyright details are in AUTHORS/THANKS.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "PathRequestService.h"
+#include "PathFinder.h"
+#include "MapManager.h"
+#include "Unit.h"
+#include "Timer.h"
+#include "Log.h"
+
+#include <algorithm>
+
+// corridors older than this are searched again, the navmesh around them may have changed
+#define PATH_CORRIDOR_LIFETIME      1000
+// more cached corridors than this are dropped all at once
+#define PATH_CORRIDOR_MAX_COUNT     4096
+
+class PathRequestWorker : public ACE_Based::Runnable
+{
+    public:
+        explicit PathRequestWorker(PathRequestService& service) : m_service(service) {}
+
+        void run() override { m_service.WorkerLoop(); }
+
+    private:
+        PathRequestService& m_service;
+};
+
+// ######################## PathCorridorCache ########################
+
+bool PathCorridorCache::Find(uint32 mapId, dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter, dtPolyRef* path, uint32& pathLength, uint32 maxPath)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, false);
+
+    CorridorMap::const_iterator itr = m_corridors.find(CorridorKey(mapId, startPoly, endPoly, filter));
+    if (itr == m_corridors.end())
+        return false;
+
+    if (WorldTimer::getMSTimeDiff(itr->second.storeTime, WorldTimer::getMSTime()) > PATH_CORRIDOR_LIFETIME || itr->second.polys.size() > maxPath)
+        return false;
+
+    std::copy(itr->second.polys.begin(), itr->second.polys.end(), path);
+    pathLength = itr->second.polys.size();
+    ++m_hits;
+    return true;
+}
+
+void PathCorridorCache::Store(uint32 mapId, dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter, dtPolyRef const* path, uint32 pathLength)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    if (m_corridors.size() >= PATH_CORRIDOR_MAX_COUNT)
+        m_corridors.clear();
+
+    Corridor& corridor = m_corridors[CorridorKey(mapId, startPoly, endPoly, filter)];
+    corridor.polys.assign(path, path + pathLength);
+    corridor.storeTime = WorldTimer::getMSTime();
+}
+
+void PathCorridorCache::Clear()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    m_corridors.clear();
+}
+
+uint32 PathCorridorCache::GetHits(bool reset)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, 0);
+
+    uint32 hits = m_hits;
+    if (reset)
+        m_hits = 0;
+
+    return hits;
+}
+
+// ######################## PathRequestService ########################
+
+PathRequestService::PathRequestService() : m_workCondition(m_lock), m_running(false)
+{
+}
+
+PathRequestService::~PathRequestService()
+{
+    Deactivate();
+}
+
+void PathRequestService::Activate(uint32 numThreads)
+{
+    if (IsActivated() || !numThreads)
+        return;
+
+    m_running = true;
+    for (uint32 i = 0; i < numThreads; ++i)
+        m_workers.push_back(new ACE_Based::Thread(new PathRequestWorker(*this)));
+
+    sLog.outString("Paths of moving creatures will be calculated by %u thread(s)", numThreads);
+}
+
+void PathRequestService::Deactivate()
+{
+    if (!IsActivated())
+        return;
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+        m_running = false;
+        m_workCondition.broadcast();
+    }
+
+    for (WorkerThreads::iterator itr = m_workers.begin(); itr != m_workers.end(); ++itr)
+    {
+        (*itr)->wait();
+        delete *itr;
+    }
+
+    m_workers.clear();
+
+    // paths not calculated anymore are handed back as they are, their handles still own the jobs
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    for (std::deque<PathJob*>::const_iterator itr = m_queue.begin(); itr != m_queue.end(); ++itr)
+        FinishJob(*itr);
+
+    m_queue.clear();
+    m_queuedByKey.clear();
+    m_corridorCache.Clear();
+}
+
+PathRequestStats PathRequestService::GetStats(bool reset)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, PathRequestStats());
+
+    PathRequestStats stats = m_stats;
+    stats.corridorHits = m_corridorCache.GetHits(reset);
+    if (reset)
+        m_stats = PathRequestStats();
+
+    return stats;
+}
+
+PathRequestService::JobKey PathRequestService::MakeKey(PathFinder const& path)
+{
+    JobKey key;
+    key.mapId = path.getMapId();
+    key.filterFlags = (uint32(path.getFilter().getIncludeFlags()) << 16) | path.getFilter().getExcludeFlags();
+    key.options = (path.getPathLengthLimit() << 2) | (path.isStraightPath() ? 2 : 0) | (path.isForcedDestination() ? 1 : 0);
+
+    // positions within the same yard give the same path
+    Vector3 start = path.getStartPosition();
+    Vector3 end = path.getEndPosition();
+    for (int i = 0; i < 3; ++i)
+    {
+        key.start[i] = int32(floor(start[i]));
+        key.end[i] = int32(floor(end[i]));
+    }
+
+    return key;
+}
+
+PathRequestService::PathJob* PathRequestService::Queue(PathFinder* path)
+{
+    PathJob* job = new PathJob(path);
+    job->key = MakeKey(*path);
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, job);
+
+    ++m_stats.requests;
+
+    QueuedJobMap::const_iterator itr = m_queuedByKey.find(job->key);
+    if (itr != m_queuedByKey.end())
+    {
+        job->leader = itr->second;
+        itr->second->followers.push_back(job);
+        ++m_stats.coalesced;
+        return job;
+    }
+
+    m_queue.push_back(job);
+    m_queuedByKey[job->key] = job;
+    m_workCondition.signal();
+    return job;
+}
+
+bool PathRequestService::Requeue(PathJob* job, float x, float y, float z, bool forceDest)
+{
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, false);
+
+        // only a job calculating its own path alone can still be changed
+        if (job->state != JOB_QUEUED || job->leader || !job->followers.empty())
+            return false;
+
+        // taken out of the queue while it is prepared, no thread can start it or join it meanwhile
+        m_queue.erase(std::find(m_queue.begin(), m_queue.end(), job));
+
+        QueuedJobMap::iterator itr = m_queuedByKey.find(job->key);
+        if (itr != m_queuedByKey.end() && itr->second == job)
+            m_queuedByKey.erase(itr);
+    }
+
+    // reads the terrain, which may load map files, the workers don't wait for it
+    job->path->prepare(x, y, z, forceDest);
+    job->key = MakeKey(*job->path);
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, true);
+
+    // it waited already, it is calculated next, a job of the new key may exist already but is not merged with
+    m_queue.push_front(job);
+    if (m_queuedByKey.find(job->key) == m_queuedByKey.end())
+        m_queuedByKey[job->key] = job;
+
+    m_workCondition.signal();
+    return true;
+}
+
+bool PathRequestService::IsDone(PathJob* job)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, false);
+
+    return job->state == JOB_DONE;
+}
+
+PathFinder* PathRequestService::Take(PathJob* job)
+{
+    PathFinder* path = job->path;
+    delete job;
+    return path;
+}
+
+void PathRequestService::Cancel(PathJob* job)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    if (job->state == JOB_QUEUED)
+    {
+        if (job->leader)
+        {
+            std::vector<PathJob*>& followers = job->leader->followers;
+            followers.erase(std::find(followers.begin(), followers.end(), job));
+        }
+        else if (job->followers.empty())
+        {
+            m_queue.erase(std::find(m_queue.begin(), m_queue.end(), job));
+            QueuedJobMap::iterator itr = m_queuedByKey.find(job->key);
+            if (itr != m_queuedByKey.end() && itr->second == job)
+                m_queuedByKey.erase(itr);
+        }
+        else
+        {
+            // still calculated for the followers
+            job->cancelled = true;
+            return;
+        }
+    }
+    else if (job->state == JOB_BUILDING)
+    {
+        job->cancelled = true;
+        return;
+    }
+
+    delete job->path;
+    delete job;
+}
+
+void PathRequestService::WorkerLoop()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    while (true)
+    {
+        while (m_running && m_queue.empty())
+            m_workCondition.wait();
+
+        if (!m_running)
+            return;
+
+        PathJob* job = m_queue.front();
+        m_queue.pop_front();
+
+        QueuedJobMap::iterator itr = m_queuedByKey.find(job->key);
+        if (itr != m_queuedByKey.end() && itr->second == job)
+            m_queuedByKey.erase(itr);
+
+        job->state = JOB_BUILDING;
+
+        m_lock.release();
+        uint32 startTime = WorldTimer::getMSTime();
+        job->path->build(&m_corridorCache);
+        uint32 buildTime = WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime());
+        m_lock.acquire();
+
+        ++m_stats.built;
+        m_stats.buildTime += buildTime;
+
+        FinishJob(job);
+    }
+}
+
+// called with m_lock held
+void PathRequestService::FinishJob(PathJob* job)
+{
+    for (std::vector<PathJob*>::const_iterator itr = job->followers.begin(); itr != job->followers.end(); ++itr)
+    {
+        PathJob* follower = *itr;
+        follower->path->copyResult(*job->path);
+        follower->leader = NULL;
+        follower->state = JOB_DONE;
+    }
+
+    job->followers.clear();
+    job->state = JOB_DONE;
+
+    if (job->cancelled)
+    {
+        delete job->path;
+        delete job;
+    }
+}
+
+// ######################## PathRequestHandle ########################
+
+bool PathRequestHandle::Request(PathFinder* path, float x, float y, float z, bool forceDest)
+{
+    PathRequestService& service = sMapMgr.GetPathRequests();
+    if (!service.IsActivated())
+        return false;
+
+    Cancel();
+
+    path->prepare(x, y, z, forceDest);
+    m_job = service.Queue(path);
+    return true;
+}
+
+bool PathRequestHandle::UpdateDestination(float x, float y, float z, bool forceDest)
+{
+    return m_job && sMapMgr.GetPathRequests().Requeue(m_job, x, y, z, forceDest);
+}
+
+PathFinder* PathRequestHandle::TakeResult(Unit const& owner)
+{
+    if (!m_job)
+        return NULL;
+
+    PathRequestService& service = sMapMgr.GetPathRequests();
+    if (!service.IsDone(m_job))
+        return NULL;
+
+    PathFinder* path = service.Take(m_job);
+    m_job = NULL;
+
+    // teleported meanwhile, the path leads nowhere
+    if (path->getMapId() != owner.GetMapId())
+    {
+        delete path;
+        return NULL;
+    }
+
+    return path;
+}
+
+void PathRequestHandle::Cancel()
+{
+    if (!m_job)
+        return;
+
+    sMapMgr.GetPathRequests().Cancel(m_job);
+    m_job = NULL;
+}
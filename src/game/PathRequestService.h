@@ -0,0 +1,218 @@
+/**
+ * This code is part of MaNGOS. Contributor & Copyright details are in AUTHORS/THANKS.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PATHREQUESTSERVICE_H
+#define MANGOS_PATHREQUESTSERVICE_H
+
+#include "Common.h"
+#include "Threading.h"
+#include "ace/Thread_Mutex.h"
+#include "ace/Condition_Thread_Mutex.h"
+#include "../recastnavigation/Detour/Include/DetourNavMesh.h"
+#include "../recastnavigation/Detour/Include/DetourNavMeshQuery.h"
+
+#include <deque>
+#include <map>
+#include <vector>
+
+class PathFinder;
+class Unit;
+
+/**
+ * Polygon corridors found by recent path searches, shared by all path threads.
+ *
+ * Units chasing the same target from the same area search the same corridor again and again,
+ * a corridor is reused for a short time for any path between the same start and end polygon.
+ */
+class PathCorridorCache
+{
+    public:
+        PathCorridorCache() : m_hits(0) {}
+
+        // copies a cached corridor into path, false if there is none or it is longer than maxPath
+        bool Find(uint32 mapId, dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter, dtPolyRef* path, uint32& pathLength, uint32 maxPath);
+        void Store(uint32 mapId, dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter, dtPolyRef const* path, uint32 pathLength);
+        void Clear();
+
+        uint32 GetHits(bool reset);
+
+    private:
+        struct CorridorKey
+        {
+            CorridorKey(uint32 _mapId, dtPolyRef _startPoly, dtPolyRef _endPoly, dtQueryFilter const& filter) :
+                mapId(_mapId), filterFlags((uint32(filter.getIncludeFlags()) << 16) | filter.getExcludeFlags()),
+                startPoly(_startPoly), endPoly(_endPoly) {}
+
+            bool operator<(CorridorKey const& other) const
+            {
+                if (startPoly != other.startPoly)
+                    return startPoly < other.startPoly;
+                if (endPoly != other.endPoly)
+                    return endPoly < other.endPoly;
+                if (mapId != other.mapId)
+                    return mapId < other.mapId;
+                return filterFlags < other.filterFlags;
+            }
+
+            uint32 mapId;
+            uint32 filterFlags;
+            dtPolyRef startPoly;
+            dtPolyRef endPoly;
+        };
+
+        struct Corridor
+        {
+            std::vector<dtPolyRef> polys;
+            uint32 storeTime;
+        };
+
+        typedef std::map<CorridorKey, Corridor> CorridorMap;
+
+        ACE_Thread_Mutex m_lock;
+        CorridorMap m_corridors;
+        uint32 m_hits;
+};
+
+struct PathRequestStats
+{
+    PathRequestStats() : requests(0), coalesced(0), built(0), buildTime(0), corridorHits(0) {}
+
+    uint32 requests;                                        ///< paths queued by movement generators
+    uint32 coalesced;                                       ///< requests answered by the calculation of an identical one
+    uint32 built;                                           ///< paths calculated by the path threads
+    uint32 buildTime;                                       ///< time spent calculating them
+    uint32 corridorHits;                                    ///< calculations that reused a cached corridor
+};
+
+/**
+ * Threads calculating the paths of movement generators in the background.
+ *
+ * A generator hands its PathFinder over with PathRequestHandle::Request() after the owner data
+ * was taken by PathFinder::prepare(), and takes it back on one of its next updates. Requests for
+ * the same map, start and destination waiting at the same time are calculated only once.
+ * The calculation only reads the nav mesh, never the terrain of the map.
+ */
+class PathRequestService
+{
+    public:
+        PathRequestService();
+        ~PathRequestService();
+
+        void Activate(uint32 numThreads);
+        void Deactivate();
+        bool IsActivated() const { return !m_workers.empty(); }
+
+        PathRequestStats GetStats(bool reset);
+
+    private:
+        friend class PathRequestWorker;
+        friend class PathRequestHandle;
+
+        enum JobState
+        {
+            JOB_QUEUED,
+            JOB_BUILDING,
+            JOB_DONE
+        };
+
+        struct JobKey
+        {
+            bool operator<(JobKey const& other) const { return memcmp(this, &other, sizeof(JobKey)) < 0; }
+
+            uint32 mapId;
+            uint32 filterFlags;
+            uint32 options;                                 // path length limit, straight path and forced destination
+            int32 start[3];
+            int32 end[3];
+        };
+
+        struct PathJob
+        {
+            PathJob(PathFinder* _path) : path(_path), state(JOB_QUEUED), cancelled(false), leader(NULL) {}
+
+            PathFinder* path;
+            JobState state;
+            bool cancelled;                                 // handle gone, the job deletes itself when done
+            PathJob* leader;                                // queued job calculating this path too
+            std::vector<PathJob*> followers;                // jobs waiting for the result of this one
+            JobKey key;
+        };
+
+        static JobKey MakeKey(PathFinder const& path);
+
+        // called by PathRequestHandle, the path must be prepared
+        PathJob* Queue(PathFinder* path);
+        bool Requeue(PathJob* job, float x, float y, float z, bool forceDest);
+        bool IsDone(PathJob* job);
+        PathFinder* Take(PathJob* job);
+        void Cancel(PathJob* job);
+
+        // worker thread body, returns when the service is deactivated
+        void WorkerLoop();
+
+        void FinishJob(PathJob* job);
+
+        typedef std::vector<ACE_Based::Thread*> WorkerThreads;
+        WorkerThreads m_workers;
+
+        ACE_Thread_Mutex m_lock;
+        ACE_Condition_Thread_Mutex m_workCondition;         ///< signaled when a path was queued or at shutdown
+
+        std::deque<PathJob*> m_queue;                       ///< leading jobs waiting for a thread, oldest first
+        typedef std::map<JobKey, PathJob*> QueuedJobMap;
+        QueuedJobMap m_queuedByKey;                         ///< the same jobs by what they calculate
+        bool m_running;
+
+        PathCorridorCache m_corridorCache;
+        PathRequestStats m_stats;
+};
+
+/**
+ * Path request of a movement generator, at most one at a time.
+ *
+ * The PathFinder given to Request() is owned by the request until TakeResult() returns it,
+ * a request still pending when the handle is destroyed or cancelled is dropped by the service.
+ */
+class PathRequestHandle
+{
+    public:
+        PathRequestHandle() : m_job(NULL) {}
+        ~PathRequestHandle() { Cancel(); }
+
+        // prepares the path to the destination and queues it, returns false if paths are calculated
+        // inline (path threads disabled), the path stays with the caller then and is not prepared
+        bool Request(PathFinder* path, float x, float y, float z, bool forceDest = false);
+
+        // a queued request not started yet gets the new destination, false if too late for that
+        bool UpdateDestination(float x, float y, float z, bool forceDest = false);
+
+        bool IsPending() const { return m_job != NULL; }
+
+        // the calculated path as soon as it is ready, NULL while pending or if the owner changed map meanwhile
+        PathFinder* TakeResult(Unit const& owner);
+
+        void Cancel();
+
+    private:
+        PathRequestHandle(PathRequestHandle const&);
+        PathRequestHandle& operator=(PathRequestHandle const&);
+
+        PathRequestService::PathJob* m_job;
+};
+
+#endif
@@ -460,6 +460,9 @@ Player::Player(WorldSession* session): Unit(), m_mover(this), m_camera(this), m_
 
     m_DailyQuestChanged = false;
     m_WeeklyQuestChanged = false;
+    m_MonthlyQuestChanged = false;
+    m_spellCooldownsChanged = false;
+    m_characterRowSaved = false;
 
     m_lastLiquid = NULL;
 
@@ -1652,6 +1655,14 @@ bool Player::TeleportTo(uint32 mapid, float x, float y, float z, float orientati
 
     MapEntry const* mEntry = sMapStore.LookupEntry(mapid);  // Validity checked in IsValidMapCoord
 
+    // entering another map touches other maps and global state, so it has to wait for the end of the parallel map update
+    if (GetMapId() != mapid && IsInWorld() && MapUpdater::IsWorkerThread())
+    {
+        GetMap()->DeferCrossMapAction(new MaNGOS::Callback<Player, WorldLocation, uint32, AreaTrigger const*>
+                                      (this, &Player::DeferredTeleportTo, WorldLocation(mapid, x, y, z, orientation), options, at));
+        return true;
+    }
+
     // preparing unsummon pet if lost (we must get pet before teleportation or will not find it later)
     Pet* pet = GetPet();
 
@@ -1882,6 +1893,11 @@ bool Player::TeleportTo(uint32 mapid, float x, float y, float z, float orientati
     return true;
 }
 
+void Player::DeferredTeleportTo(WorldLocation loc, uint32 options, AreaTrigger const* at)
+{
+    TeleportTo(loc.mapid, loc.coord_x, loc.coord_y, loc.coord_z, loc.orientation, options, at);
+}
+
 bool Player::TeleportToBGEntryPoint()
 {
     ScheduleDelayedOperation(DELAYED_BG_MOUNT_RESTORE);
@@ -3556,7 +3572,8 @@ void Player::removeSpell(uint32 spell_id, bool disabled, bool learn_low_rank, bo
 
 void Player::RemoveSpellCooldown(uint32 spell_id, bool update /* = false */)
 {
-    m_spellCooldowns.erase(spell_id);
+    if (m_spellCooldowns.erase(spell_id))
+        m_spellCooldownsChanged = true;
 
     if (update)
         SendClearCooldown(spell_id, this);
@@ -3607,6 +3624,7 @@ void Player::RemoveAllSpellCooldown()
             SendClearCooldown(itr->first, this);
 
         m_spellCooldowns.clear();
+        m_spellCooldownsChanged = true;
     }
 }
 
@@ -3650,6 +3668,10 @@ void Player::_LoadSpellCooldowns(QueryResult* result)
 
 void Player::_SaveSpellCooldowns()
 {
+    // expired cooldowns are skipped at load, so rows only need a rewrite when the cooldown set changed
+    if (!m_spellCooldownsChanged)
+        return;
+
     static SqlStatementID deleteSpellCooldown ;
     static SqlStatementID insertSpellCooldown ;
 
@@ -3673,6 +3695,8 @@ void Player::_SaveSpellCooldowns()
         else
             ++itr;
     }
+
+    m_spellCooldownsChanged = false;
 }
 
 uint32 Player::resetTalentsCost() const
@@ -3843,9 +3867,9 @@ void Player::_SetCreateBits(UpdateMask* updateMask, Player* target) const
     }
     else
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint16 index = updateVisualBits.FindNextSetBit(0); index < m_valuesCount; index = updateVisualBits.FindNextSetBit(index + 1))
         {
-            if (GetUInt32Value(index) != 0 && updateVisualBits.GetBit(index))
+            if (GetUInt32Value(index) != 0)
                 updateMask->SetBit(index);
         }
     }
@@ -4306,12 +4330,24 @@ void Player::DeleteFromDB(ObjectGuid playerguid, uint32 accountId, bool updateRe
             CharacterDatabase.PExecute("DELETE FROM guild_eventlog WHERE PlayerGuid1 = '%u' OR PlayerGuid2 = '%u'", lowguid, lowguid);
             CharacterDatabase.PExecute("DELETE FROM guild_bank_eventlog WHERE PlayerGuid = '%u'", lowguid);
             CharacterDatabase.CommitTransaction();
+
+            sObjectMgr.RemoveCharacterNameData(lowguid);
             break;
         }
         // The character gets unlinked from the account, the name gets freed up and appears as deleted ingame
         case 1:
+        {
             CharacterDatabase.PExecute("UPDATE characters SET deleteInfos_Name=name, deleteInfos_Account=account, deleteDate='" UI64FMTD "', name='', account=0 WHERE guid=%u", uint64(time(NULL)), lowguid);
+
+            CharacterNameData nameData;
+            if (sObjectMgr.GetCharacterNameData(lowguid, nameData))
+            {
+                nameData.name.clear();
+                nameData.account = 0;
+                sObjectMgr.SetCharacterNameData(lowguid, nameData);
+            }
             break;
+        }
         default:
             sLog.outError("Player::DeleteFromDB: Unsupported delete method: %u.", charDelete_method);
     }
@@ -15640,6 +15676,7 @@ bool Player::LoadFromDB(ObjectGuid guid, SqlQueryHolder* holder)
     }
 
     Object::_Create(guid.GetCounter(), 0, HIGHGUID_PLAYER);
+    m_characterRowSaved = true;
 
     m_name = fields[2].GetCppString();
 
@@ -17424,6 +17461,27 @@ bool Player::_LoadHomeBind(QueryResult* result)
 /***                   SAVE SYSTEM                     ***/
 /*********************************************************/
 
+// players are saved from the map update threads
+static ACE_Thread_Mutex s_saveStatsLock;
+static PlayerSaveStats s_saveStats;
+
+static void AddSaveStats(uint32 statements, uint32 bytes)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, s_saveStatsLock);
+    ++s_saveStats.saves;
+    s_saveStats.statements += statements;
+    s_saveStats.bytes += bytes;
+}
+
+PlayerSaveStats Player::GetSaveStats(bool reset)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, s_saveStatsLock, PlayerSaveStats());
+    PlayerSaveStats stats = s_saveStats;
+    if (reset)
+        s_saveStats = PlayerSaveStats();
+    return stats;
+}
+
 void Player::SaveToDB()
 {
     // we should assure this: ASSERT((m_nextSave != sWorld.getConfig(CONFIG_UINT32_INTERVAL_SAVE)));
@@ -17440,18 +17498,30 @@ void Player::SaveToDB()
     // first save/honor gain after midnight will also update the player's honor fields
     UpdateHonorFields();
 
+    // saves of different characters may be executed in parallel
+    SqlAsyncOrderGuard orderGuard(CharacterDatabase, GetObjectGuid().GetRawValue());
+
     DEBUG_FILTER_LOG(LOG_FILTER_PLAYER_STATS, "The value of player %s at save: ", m_name.c_str());
     outDebugStatsValues();
 
     CharacterDatabase.BeginTransaction();
 
-    static SqlStatementID delChar ;
     static SqlStatementID insChar ;
-
-    SqlStatement stmt = CharacterDatabase.CreateStatement(delChar, "DELETE FROM characters WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
-
-    SqlStatement uberInsert = CharacterDatabase.CreateStatement(insChar, "INSERT INTO characters (guid,account,name,race,class,gender,level,xp,money,playerBytes,playerBytes2,playerFlags,"
+    static SqlStatementID updChar ;
+
+    // the characters row is created by the first save, later saves only update it
+    SqlStatement uberSave = m_characterRowSaved ? CharacterDatabase.CreateStatement(updChar, "UPDATE characters SET guid = ?, account = ?, name = ?, race = ?, class = ?, gender = ?, level = ?, xp = ?, money = ?, "
+                              "playerBytes = ?, playerBytes2 = ?, playerFlags = ?, map = ?, dungeon_difficulty = ?, position_x = ?, "
+                              "position_y = ?, position_z = ?, orientation = ?, taximask = ?, online = ?, cinematic = ?, totaltime = ?, "
+                              "leveltime = ?, rest_bonus = ?, logout_time = ?, is_logout_resting = ?, resettalents_cost = ?, "
+                              "resettalents_time = ?, trans_x = ?, trans_y = ?, trans_z = ?, trans_o = ?, transguid = ?, extra_flags = ?, "
+                              "stable_slots = ?, at_login = ?, zone = ?, death_expire_time = ?, taxi_path = ?, arenaPoints = ?, "
+                              "totalHonorPoints = ?, todayHonorPoints = ?, yesterdayHonorPoints = ?, totalKills = ?, todayKills = ?, "
+                              "yesterdayKills = ?, chosenTitle = ?, knownCurrencies = ?, watchedFaction = ?, drunk = ?, health = ?, "
+                              "power1 = ?, power2 = ?, power3 = ?, power4 = ?, power5 = ?, power6 = ?, power7 = ?, specCount = ?, "
+                              "activeSpec = ?, exploredZones = ?, equipmentCache = ?, ammoId = ?, knownTitles = ?, actionBars = ? "
+                              "WHERE guid = ?")
+                            : CharacterDatabase.CreateStatement(insChar, "INSERT INTO characters (guid,account,name,race,class,gender,level,xp,money,playerBytes,playerBytes2,playerFlags,"
                               "map, dungeon_difficulty, position_x, position_y, position_z, orientation, "
                               "taximask, online, cinematic, "
                               "totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_cost, resettalents_time, "
@@ -17468,133 +17538,146 @@ void Player::SaveToDB()
                               "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
                               "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?) ");
 
-    uberInsert.addUInt32(GetGUIDLow());
-    uberInsert.addUInt32(GetSession()->GetAccountId());
-    uberInsert.addString(m_name);
-    uberInsert.addUInt8(getRace());
-    uberInsert.addUInt8(getClass());
-    uberInsert.addUInt8(getGender());
-    uberInsert.addUInt32(getLevel());
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_XP));
-    uberInsert.addUInt32(GetMoney());
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_BYTES));
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_BYTES_2));
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FLAGS));
+    uberSave.addUInt32(GetGUIDLow());
+    uberSave.addUInt32(GetSession()->GetAccountId());
+    uberSave.addString(m_name);
+    uberSave.addUInt8(getRace());
+    uberSave.addUInt8(getClass());
+    uberSave.addUInt8(getGender());
+    uberSave.addUInt32(getLevel());
+    uberSave.addUInt32(GetUInt32Value(PLAYER_XP));
+    uberSave.addUInt32(GetMoney());
+    uberSave.addUInt32(GetUInt32Value(PLAYER_BYTES));
+    uberSave.addUInt32(GetUInt32Value(PLAYER_BYTES_2));
+    uberSave.addUInt32(GetUInt32Value(PLAYER_FLAGS));
 
     if (!IsBeingTeleported())
     {
-        uberInsert.addUInt32(GetMapId());
-        uberInsert.addUInt32(uint32(GetDungeonDifficulty()));
-        uberInsert.addFloat(finiteAlways(GetPositionX()));
-        uberInsert.addFloat(finiteAlways(GetPositionY()));
-        uberInsert.addFloat(finiteAlways(GetPositionZ()));
-        uberInsert.addFloat(finiteAlways(GetOrientation()));
+        uberSave.addUInt32(GetMapId());
+        uberSave.addUInt32(uint32(GetDungeonDifficulty()));
+        uberSave.addFloat(finiteAlways(GetPositionX()));
+        uberSave.addFloat(finiteAlways(GetPositionY()));
+        uberSave.addFloat(finiteAlways(GetPositionZ()));
+        uberSave.addFloat(finiteAlways(GetOrientation()));
     }
     else
     {
-        uberInsert.addUInt32(GetTeleportDest().mapid);
-        uberInsert.addUInt32(uint32(GetDungeonDifficulty()));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().coord_x));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().coord_y));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().coord_z));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().orientation));
+        uberSave.addUInt32(GetTeleportDest().mapid);
+        uberSave.addUInt32(uint32(GetDungeonDifficulty()));
+        uberSave.addFloat(finiteAlways(GetTeleportDest().coord_x));
+        uberSave.addFloat(finiteAlways(GetTeleportDest().coord_y));
+        uberSave.addFloat(finiteAlways(GetTeleportDest().coord_z));
+        uberSave.addFloat(finiteAlways(GetTeleportDest().orientation));
     }
 
     std::ostringstream ss;
     ss << m_taxi;                                   // string with TaxiMaskSize numbers
-    uberInsert.addString(ss);
+    uberSave.addString(ss);
 
-    uberInsert.addUInt32(IsInWorld() ? 1 : 0);
+    uberSave.addUInt32(IsInWorld() ? 1 : 0);
 
-    uberInsert.addUInt32(m_cinematic);
+    uberSave.addUInt32(m_cinematic);
 
-    uberInsert.addUInt32(m_Played_time[PLAYED_TIME_TOTAL]);
-    uberInsert.addUInt32(m_Played_time[PLAYED_TIME_LEVEL]);
+    uberSave.addUInt32(m_Played_time[PLAYED_TIME_TOTAL]);
+    uberSave.addUInt32(m_Played_time[PLAYED_TIME_LEVEL]);
 
-    uberInsert.addFloat(finiteAlways(m_rest_bonus));
-    uberInsert.addUInt64(uint64(time(NULL)));
-    uberInsert.addUInt32(HasFlag(PLAYER_FLAGS, PLAYER_FLAGS_RESTING) ? 1 : 0);
+    uberSave.addFloat(finiteAlways(m_rest_bonus));
+    uberSave.addUInt64(uint64(time(NULL)));
+    uberSave.addUInt32(HasFlag(PLAYER_FLAGS, PLAYER_FLAGS_RESTING) ? 1 : 0);
     // save, far from tavern/city
     // save, but in tavern/city
-    uberInsert.addUInt32(m_resetTalentsCost);
-    uberInsert.addUInt64(uint64(m_resetTalentsTime));
+    uberSave.addUInt32(m_resetTalentsCost);
+    uberSave.addUInt64(uint64(m_resetTalentsTime));
 
-    uberInsert.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->x));
-    uberInsert.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->y));
-    uberInsert.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->z));
-    uberInsert.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->o));
+    uberSave.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->x));
+    uberSave.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->y));
+    uberSave.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->z));
+    uberSave.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->o));
     if (m_transport)
-        uberInsert.addUInt32(m_transport->GetGUIDLow());
+        uberSave.addUInt32(m_transport->GetGUIDLow());
     else
-        uberInsert.addUInt32(0);
+        uberSave.addUInt32(0);
 
-    uberInsert.addUInt32(m_ExtraFlags);
+    uberSave.addUInt32(m_ExtraFlags);
 
-    uberInsert.addUInt32(uint32(m_stableSlots));            // to prevent save uint8 as char
+    uberSave.addUInt32(uint32(m_stableSlots));            // to prevent save uint8 as char
 
-    uberInsert.addUInt32(uint32(m_atLoginFlags));
+    uberSave.addUInt32(uint32(m_atLoginFlags));
 
-    uberInsert.addUInt32(IsInWorld() ? GetZoneId() : GetCachedZoneId());
+    uberSave.addUInt32(IsInWorld() ? GetZoneId() : GetCachedZoneId());
 
-    uberInsert.addUInt64(uint64(m_deathExpireTime));
+    uberSave.addUInt64(uint64(m_deathExpireTime));
 
     ss << m_taxi.SaveTaxiDestinationsToString();       // string
-    uberInsert.addString(ss);
+    uberSave.addString(ss);
 
-    uberInsert.addUInt32(GetArenaPoints());
+    uberSave.addUInt32(GetArenaPoints());
 
-    uberInsert.addUInt32(GetHonorPoints());
+    uberSave.addUInt32(GetHonorPoints());
 
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FIELD_TODAY_CONTRIBUTION));
+    uberSave.addUInt32(GetUInt32Value(PLAYER_FIELD_TODAY_CONTRIBUTION));
 
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FIELD_YESTERDAY_CONTRIBUTION));
+    uberSave.addUInt32(GetUInt32Value(PLAYER_FIELD_YESTERDAY_CONTRIBUTION));
 
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FIELD_LIFETIME_HONORBALE_KILLS));
+    uberSave.addUInt32(GetUInt32Value(PLAYER_FIELD_LIFETIME_HONORBALE_KILLS));
 
-    uberInsert.addUInt16(GetUInt16Value(PLAYER_FIELD_KILLS, 0));
+    uberSave.addUInt16(GetUInt16Value(PLAYER_FIELD_KILLS, 0));
 
-    uberInsert.addUInt16(GetUInt16Value(PLAYER_FIELD_KILLS, 1));
+    uberSave.addUInt16(GetUInt16Value(PLAYER_FIELD_KILLS, 1));
 
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_CHOSEN_TITLE));
+    uberSave.addUInt32(GetUInt32Value(PLAYER_CHOSEN_TITLE));
 
-    uberInsert.addUInt64(GetUInt64Value(PLAYER_FIELD_KNOWN_CURRENCIES));
+    uberSave.addUInt64(GetUInt64Value(PLAYER_FIELD_KNOWN_CURRENCIES));
 
     // FIXME: at this moment send to DB as unsigned, including unit32(-1)
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FIELD_WATCHED_FACTION_INDEX));
+    uberSave.addUInt32(GetUInt32Value(PLAYER_FIELD_WATCHED_FACTION_INDEX));
 
-    uberInsert.addUInt8(GetDrunkValue());
+    uberSave.addUInt8(GetDrunkValue());
 
-    uberInsert.addUInt32(GetHealth());
+    uberSave.addUInt32(GetHealth());
 
     for (uint32 i = 0; i < MAX_POWERS; ++i)
-        uberInsert.addUInt32(GetPower(Powers(i)));
+        uberSave.addUInt32(GetPower(Powers(i)));
 
-    uberInsert.addUInt32(uint32(m_specsCount));
-    uberInsert.addUInt32(uint32(m_activeSpec));
+    uberSave.addUInt32(uint32(m_specsCount));
+    uberSave.addUInt32(uint32(m_activeSpec));
 
     for (uint32 i = 0; i < PLAYER_EXPLORED_ZONES_SIZE; ++i) // string
     {
         ss << GetUInt32Value(PLAYER_EXPLORED_ZONES_1 + i) << " ";
     }
-    uberInsert.addString(ss);
+    uberSave.addString(ss);
 
     for (uint32 i = 0; i < EQUIPMENT_SLOT_END * 2; ++i)     // string
     {
         ss << GetUInt32Value(PLAYER_VISIBLE_ITEM_1_ENTRYID + i) << " ";
     }
-    uberInsert.addString(ss);
+    uberSave.addString(ss);
 
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_AMMO_ID));
+    uberSave.addUInt32(GetUInt32Value(PLAYER_AMMO_ID));
 
     for (uint32 i = 0; i < KNOWN_TITLES_SIZE * 2; ++i)      // string
     {
         ss << GetUInt32Value(PLAYER__FIELD_KNOWN_TITLES + i) << " ";
     }
-    uberInsert.addString(ss);
+    uberSave.addString(ss);
+
+    uberSave.addUInt32(uint32(GetByteValue(PLAYER_FIELD_BYTES, 2)));
+
+    if (m_characterRowSaved)
+        uberSave.addUInt32(GetGUIDLow());
 
-    uberInsert.addUInt32(uint32(GetByteValue(PLAYER_FIELD_BYTES, 2)));
+    uberSave.Execute();
+    m_characterRowSaved = true;
 
-    uberInsert.Execute();
+    CharacterNameData nameData;
+    nameData.name = m_name;
+    nameData.account = GetSession()->GetAccountId();
+    nameData.race = getRace();
+    nameData.gender = getGender();
+    nameData.playerClass = getClass();
+    nameData.level = uint8(getLevel());
+    sObjectMgr.SetCharacterNameData(GetGUIDLow(), nameData);
 
     if (m_mailsUpdated)                                     // save mails only when needed
         _SaveMail();
@@ -17617,6 +17700,12 @@ void Player::SaveToDB()
     _SaveGlyphs();
     _SaveTalents();
 
+    uint32 statements, bytes;
+    CharacterDatabase.GetTransactionSize(statements, bytes);
+    AddSaveStats(statements, bytes);
+
+    DEBUG_FILTER_LOG(LOG_FILTER_PLAYER_STATS, "Player::SaveToDB: %s saved with %u statements, %u bytes", GetGuidStr().c_str(), statements, bytes);
+
     CharacterDatabase.CommitTransaction();
 
     // check if stats should only be saved on logout
@@ -18831,7 +18920,11 @@ void Player::AddSpellMod(Aura* aura, bool apply)
     if (apply)
         m_spellMods[mod->m_miscvalue].push_back(aura);
     else
+    {
+        // the spell mods are only walked by ApplySpellMod, which doesn't change them
         m_spellMods[mod->m_miscvalue].remove(aura);
+        m_spellMods[mod->m_miscvalue].Compact();
+    }
 }
 
 template <class T> T Player::ApplySpellMod(uint32 spellId, SpellModOp op, T& basevalue, Spell const* /*spell*/)
@@ -19772,6 +19865,7 @@ void Player::AddSpellCooldown(uint32 spellid, uint32 itemid, time_t end_time)
     sc.end = end_time;
     sc.itemid = itemid;
     m_spellCooldowns[spellid] = sc;
+    m_spellCooldownsChanged = true;
 }
 
 void Player::SendCooldownEvent(SpellEntry const* spellInfo, uint32 itemId, Spell* spell)
@@ -943,6 +943,16 @@ struct BGData
     bool HasTaxiPath() const { return taxiPath[0] && taxiPath[1]; }
 };
 
+/// Character DB load caused by Player::SaveToDB, accumulated over all saves since the last reset
+struct PlayerSaveStats
+{
+    PlayerSaveStats() : saves(0), statements(0), bytes(0) {}
+
+    uint32 saves;
+    uint64 statements;                                      ///< statements queued in the save transactions
+    uint64 bytes;                                           ///< statement data (SQL text or bound parameters) of these statements
+};
+
 class TradeData
 {
     public:                                                 // constructors
@@ -1456,6 +1466,9 @@ class MANGOS_DLL_SPEC Player : public Unit
         static void DeleteOldCharacters();
         static void DeleteOldCharacters(uint32 keepDays);
 
+        // character DB load of all saves since the last call with reset
+        static PlayerSaveStats GetSaveStats(bool reset);
+
         bool m_mailsUpdated;
 
         void SendPetTameFailure(PetTameFailureReason reason);
@@ -2494,6 +2507,8 @@ class MANGOS_DLL_SPEC Player : public Unit
         bool   m_DailyQuestChanged;
         bool   m_WeeklyQuestChanged;
         bool   m_MonthlyQuestChanged;
+        bool   m_spellCooldownsChanged;
+        bool   m_characterRowSaved;                         ///< characters row exists, saves update it in place
 
         uint32 m_drunkTimer;
         uint32 m_weaponChangeTimer;
@@ -2567,6 +2582,9 @@ class MANGOS_DLL_SPEC Player : public Unit
         void UpdateKnownCurrencies(uint32 itemId, bool apply);
         void AdjustQuestReqItemCount(Quest const* pQuest, QuestStatusData& questStatusData);
 
+        // far teleport requested from a map update worker, executed after all maps were updated
+        void DeferredTeleportTo(WorldLocation loc, uint32 options, AreaTrigger const* at);
+
         void SetCanDelayTeleport(bool setting) { m_bCanDelayTeleport = setting; }
         bool IsHasDelayedTeleport() const
         {
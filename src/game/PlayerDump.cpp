@@ -408,6 +408,9 @@ DumpReturn PlayerDumpWriter::WriteDump(const std::string& file, uint32 guid)
 DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, std::string name, uint32 guid)
 {
     bool nameInvalidated = false;                           // set when name changed or will requested changed at next login
+    CharacterNameData nameData;                             // for the name cache, set once the dump is loaded
+    DeclinedName declinedNames;
+    bool hasDeclinedNames = false;
 
     // check character count
     uint32 charcount = sAccountMgr.GetCharactersCount(account);
@@ -540,6 +543,10 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
                     break;
                 }
 
+                for (int i = 0; i < MAX_DECLINED_NAME_CASES; ++i)
+                    declinedNames.name[i] = getnth(line, i + 2);
+                hasDeclinedNames = !declinedNames.name[0].empty();
+
                 if (!changenth(line, 1, newguid))           // character_*.guid update
                     ROLLBACK(DUMP_FILE_BROKEN);
                 break;
@@ -577,6 +584,12 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
                     nameInvalidated = true;
                 }
 
+                nameData.account = account;
+                nameData.name = getnth(line, 3);            // characters.name
+                nameData.race = uint8(atoi(getnth(line, 4).c_str()));
+                nameData.playerClass = uint8(atoi(getnth(line, 5).c_str()));
+                nameData.gender = uint8(atoi(getnth(line, 6).c_str()));
+                nameData.level = uint8(atoi(getnth(line, 7).c_str()));
                 break;
             }
             case DTT_INVENTORY:
@@ -725,6 +738,10 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
 
     CharacterDatabase.CommitTransaction();
 
+    sObjectMgr.SetCharacterNameData(guid, nameData);
+    if (hasDeclinedNames)
+        sObjectMgr.SetCharacterDeclinedNames(guid, &declinedNames);
+
     // FIXME: current code with post-updating guids not safe for future per-map threads
     sObjectMgr.m_ItemGuids.Set(sObjectMgr.m_ItemGuids.GetNextAfterMaxUsed() + items.size());
     sObjectMgr.m_MailIds.Set(sObjectMgr.m_MailIds.GetNextAfterMaxUsed() +  mails.size());
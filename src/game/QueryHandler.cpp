@@ -60,52 +60,26 @@ void WorldSession::SendNameQueryOpcode(Player* p)
     SendPacket(&data);
 }
 
-void WorldSession::SendNameQueryOpcodeFromDB(ObjectGuid guid)
+void WorldSession::SendNameQueryOpcodeFromCache(ObjectGuid guid)
 {
-    CharacterDatabase.AsyncPQuery(&WorldSession::SendNameQueryOpcodeFromDBCallBack, GetAccountId(),
-                                  !sWorld.getConfig(CONFIG_BOOL_DECLINED_NAMES_USED) ?
-                                  //   ------- Query Without Declined Names --------
-                                  //          0     1     2     3       4
-                                  "SELECT guid, name, race, gender, class "
-                                  "FROM characters WHERE guid = '%u'"
-                                  :
-                                  //   --------- Query With Declined Names ---------
-                                  //          0                1     2     3       4
-                                  "SELECT characters.guid, name, race, gender, class, "
-                                  //   5         6       7           8             9
-                                  "genitive, dative, accusative, instrumental, prepositional "
-                                  "FROM characters LEFT JOIN character_declinedname ON characters.guid = character_declinedname.guid WHERE characters.guid = '%u'",
-                                  guid.GetCounter());
-}
-
-void WorldSession::SendNameQueryOpcodeFromDBCallBack(QueryResult* result, uint32 accountId)
-{
-    if (!result)
-        return;
-
-    WorldSession* session = sWorld.FindSession(accountId);
-    if (!session)
-    {
-        delete result;
+    CharacterNameData nameData;
+    if (!sObjectMgr.GetCharacterNameData(guid.GetCounter(), nameData))
         return;
-    }
 
-    Field* fields = result->Fetch();
-    uint32 lowguid      = fields[0].GetUInt32();
-    std::string name = fields[1].GetCppString();
+    std::string name = nameData.name;
     uint8 pRace = 0, pGender = 0, pClass = 0;
-    if (name == "")
-        name         = session->GetMangosString(LANG_NON_EXIST_CHARACTER);
+    if (name.empty())                                       // deleted character, kept unlinked
+        name = GetMangosString(LANG_NON_EXIST_CHARACTER);
     else
     {
-        pRace        = fields[2].GetUInt8();
-        pGender      = fields[3].GetUInt8();
-        pClass       = fields[4].GetUInt8();
+        pRace = nameData.race;
+        pGender = nameData.gender;
+        pClass = nameData.playerClass;
     }
 
     // guess size
     WorldPacket data(SMSG_NAME_QUERY_RESPONSE, (8 + 1 + 1 + 1 + 1 + 1 + 1 + 10));
-    data << ObjectGuid(HIGHGUID_PLAYER, lowguid).WriteAsPacked();
+    data << guid.WriteAsPacked();
     data << uint8(0);                                       // added in 3.1; if > 1, then end of packet
     data << name;
     data << uint8(0);                                       // realm name for cross realm BG usage
@@ -113,18 +87,17 @@ void WorldSession::SendNameQueryOpcodeFromDBCallBack(QueryResult* result, uint32
     data << uint8(pGender);                                 // gender
     data << uint8(pClass);                                  // class
 
-    // if the first declined name field (5) is empty, the rest must be too
-    if (sWorld.getConfig(CONFIG_BOOL_DECLINED_NAMES_USED) && fields[5].GetCppString() != "")
+    DeclinedName names;
+    if (sObjectMgr.GetCharacterDeclinedNames(guid.GetCounter(), names))
     {
         data << uint8(1);                                   // is declined
-        for (int i = 5; i < MAX_DECLINED_NAME_CASES + 5; ++i)
-            data << fields[i].GetCppString();
+        for (int i = 0; i < MAX_DECLINED_NAME_CASES; ++i)
+            data << names.name[i];
     }
     else
         data << uint8(0);                                   // is not declined
 
-    session->SendPacket(&data);
-    delete result;
+    SendPacket(&data);
 }
 
 void WorldSession::HandleNameQueryOpcode(WorldPacket& recv_data)
@@ -138,7 +111,7 @@ void WorldSession::HandleNameQueryOpcode(WorldPacket& recv_data)
     if (pChar)
         SendNameQueryOpcode(pChar);
     else
-        SendNameQueryOpcodeFromDB(guid);
+        SendNameQueryOpcodeFromCache(guid);
 }
 
 void WorldSession::HandleQueryTimeOpcode(WorldPacket & /*recv_data*/)
@@ -159,6 +132,9 @@ void WorldSession::HandleCreatureQueryOpcode(WorldPacket& recv_data)
     {
         int loc_idx = GetSessionDbLocaleIndex();
 
+        if (sObjectMgr.GetQueryResponseCache().Send(this, QUERY_RESPONSE_CREATURE, entry, loc_idx))
+            return;
+
         char const* name = ci->Name;
         char const* subName = ci->SubName;
         sObjectMgr.GetCreatureLocaleStrings(entry, loc_idx, &name, &subName);
@@ -187,6 +163,8 @@ void WorldSession::HandleCreatureQueryOpcode(WorldPacket& recv_data)
         for (uint32 i = 0; i < 6; ++i)
             data << uint32(ci->questItems[i]);              // itemId[6], quest drop
         data << uint32(ci->movementId);                     // CreatureMovementInfo.dbc
+
+        sObjectMgr.GetQueryResponseCache().Store(QUERY_RESPONSE_CREATURE, entry, loc_idx, data);
         SendPacket(&data);
         DEBUG_LOG("WORLD: Sent SMSG_CREATURE_QUERY_RESPONSE");
     }
@@ -212,6 +190,11 @@ void WorldSession::HandleGameObjectQueryOpcode(WorldPacket& recv_data)
     const GameObjectInfo* info = ObjectMgr::GetGameObjectInfo(entryID);
     if (info)
     {
+        int loc_idx = GetSessionDbLocaleIndex();
+
+        if (sObjectMgr.GetQueryResponseCache().Send(this, QUERY_RESPONSE_GAMEOBJECT, entryID, loc_idx))
+            return;
+
         std::string Name;
         std::string IconName;
         std::string CastBarCaption;
@@ -220,7 +203,6 @@ void WorldSession::HandleGameObjectQueryOpcode(WorldPacket& recv_data)
         IconName = info->IconName;
         CastBarCaption = info->castBarCaption;
 
-        int loc_idx = GetSessionDbLocaleIndex();
         if (loc_idx >= 0)
         {
             GameObjectLocale const* gl = sObjectMgr.GetGameObjectLocale(entryID);
@@ -246,6 +228,8 @@ void WorldSession::HandleGameObjectQueryOpcode(WorldPacket& recv_data)
         data << float(info->size);                          // go size
         for (uint32 i = 0; i < 6; ++i)
             data << uint32(info->questItems[i]);            // itemId[6], quest drop
+
+        sObjectMgr.GetQueryResponseCache().Store(QUERY_RESPONSE_GAMEOBJECT, entryID, loc_idx, data);
         SendPacket(&data);
         DEBUG_LOG("WORLD: Sent SMSG_GAMEOBJECT_QUERY_RESPONSE");
     }
@@ -0,0 +1,60 @@
+/**
+ * This code is part of MaNGOS. Contributor & Copyright details are in AUTHORS/THANKS.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "QueryResponseCache.h"
+#include "WorldPacket.h"
+#include "WorldSession.h"
+
+QueryResponseCache::~QueryResponseCache()
+{
+    for (int i = 0; i < MAX_QUERY_RESPONSE_TYPES; ++i)
+        Clear(QueryResponseType(i));
+}
+
+bool QueryResponseCache::Send(WorldSession* session, QueryResponseType type, uint32 entry, int loc_idx)
+{
+    ACE_READ_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, m_lock, false);
+
+    ResponseMap::const_iterator itr = m_responses[type].find(MakeKey(entry, loc_idx));
+    if (itr == m_responses[type].end())
+        return false;
+
+    // the socket copies the packet, it can't be cleared meanwhile
+    session->SendPacket(itr->second);
+    return true;
+}
+
+void QueryResponseCache::Store(QueryResponseType type, uint32 entry, int loc_idx, WorldPacket const& packet)
+{
+    ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, m_lock);
+
+    // another thread may have stored it meanwhile
+    WorldPacket*& response = m_responses[type][MakeKey(entry, loc_idx)];
+    if (!response)
+        response = new WorldPacket(packet);
+}
+
+void QueryResponseCache::Clear(QueryResponseType type)
+{
+    ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, m_lock);
+
+    for (ResponseMap::const_iterator itr = m_responses[type].begin(); itr != m_responses[type].end(); ++itr)
+        delete itr->second;
+
+    m_responses[type].clear();
+}
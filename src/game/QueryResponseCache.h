@@ -0,0 +1,69 @@
+/**
+ * This code is part of MaNGOS. Contributor & Copyright details are in AUTHORS/THANKS.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_QUERYRESPONSECACHE_H
+#define MANGOS_QUERYRESPONSECACHE_H
+
+#include "Common.h"
+#include "ace/RW_Thread_Mutex.h"
+
+class WorldPacket;
+class WorldSession;
+
+enum QueryResponseType
+{
+    QUERY_RESPONSE_ITEM             = 0,                    // SMSG_ITEM_QUERY_SINGLE_RESPONSE
+    QUERY_RESPONSE_CREATURE         = 1,                    // SMSG_CREATURE_QUERY_RESPONSE
+    QUERY_RESPONSE_GAMEOBJECT       = 2,                    // SMSG_GAMEOBJECT_QUERY_RESPONSE
+    MAX_QUERY_RESPONSE_TYPES        = 3
+};
+
+/**
+ * Responses to the template queries of the clients, built once per entry and locale.
+ *
+ * The templates don't change while the server runs, only their locale strings can be reloaded,
+ * which clears the responses of that template type. The query handlers run in the map threads,
+ * the responses are shared by all of them.
+ */
+class QueryResponseCache
+{
+    public:
+        QueryResponseCache() {}
+        ~QueryResponseCache();
+
+        // sends the response stored for the entry in the locale, false if there is none yet
+        bool Send(WorldSession* session, QueryResponseType type, uint32 entry, int loc_idx);
+
+        // keeps a copy of a built response for the next queries
+        void Store(QueryResponseType type, uint32 entry, int loc_idx, WorldPacket const& packet);
+
+        void Clear(QueryResponseType type);
+
+    private:
+        QueryResponseCache(QueryResponseCache const&);
+        QueryResponseCache& operator=(QueryResponseCache const&);
+
+        static uint64 MakeKey(uint32 entry, int loc_idx) { return (uint64(loc_idx + 1) << 32) | entry; }
+
+        typedef UNORDERED_MAP<uint64, WorldPacket*> ResponseMap;
+
+        ACE_RW_Thread_Mutex m_lock;
+        ResponseMap m_responses[MAX_QUERY_RESPONSE_TYPES];
+};
+
+#endif
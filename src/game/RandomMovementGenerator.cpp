@@ -21,6 +21,7 @@
 #include "RandomMovementGenerator.h"
 #include "Map.h"
 #include "Util.h"
+#include "PathFinder.h"
 #include "movement/MoveSplineInit.h"
 #include "movement/MoveSpline.h"
 
@@ -38,6 +39,15 @@ RandomMovementGenerator<Creature>::RandomMovementGenerator(const Creature& creat
     i_verticalZ = 0.0f;
 }
 
+template<>
+void RandomMovementGenerator<Creature>::_moveByPath(Creature& creature, PathFinder& path)
+{
+    Movement::MoveSplineInit init(creature);
+    init.MovebyPath(path.getPath());
+    init.SetWalk(true);
+    init.Launch();
+}
+
 template<>
 void RandomMovementGenerator<Creature>::_setRandomLocation(Creature& creature)
 {
@@ -51,10 +61,14 @@ void RandomMovementGenerator<Creature>::_setRandomLocation(Creature& creature)
 
     creature.addUnitState(UNIT_STAT_ROAMING_MOVE);
 
-    Movement::MoveSplineInit init(creature);
-    init.MoveTo(destX, destY, destZ, true);
-    init.SetWalk(true);
-    init.Launch();
+    // with path threads the creature starts moving in Update() once the path is calculated
+    PathFinder* path = new PathFinder(&creature);
+    if (!i_pathRequest.Request(path, destX, destY, destZ))
+    {
+        path->calculate(destX, destY, destZ);
+        _moveByPath(creature, *path);
+        delete path;
+    }
 
     if (creature.CanFly())
         i_nextMoveTime.Reset(0);
@@ -82,6 +96,7 @@ void RandomMovementGenerator<Creature>::Reset(Creature& creature)
 template<>
 void RandomMovementGenerator<Creature>::Interrupt(Creature& creature)
 {
+    i_pathRequest.Cancel();
     creature.InterruptMoving();
     creature.clearUnitState(UNIT_STAT_ROAMING | UNIT_STAT_ROAMING_MOVE);
     creature.SetWalk(!creature.hasUnitState(UNIT_STAT_RUNNING_STATE), false);
@@ -90,6 +105,7 @@ void RandomMovementGenerator<Creature>::Interrupt(Creature& creature)
 template<>
 void RandomMovementGenerator<Creature>::Finalize(Creature& creature)
 {
+    i_pathRequest.Cancel();
     creature.clearUnitState(UNIT_STAT_ROAMING | UNIT_STAT_ROAMING_MOVE);
     creature.SetWalk(!creature.hasUnitState(UNIT_STAT_RUNNING_STATE), false);
 }
@@ -104,7 +120,13 @@ bool RandomMovementGenerator<Creature>::Update(Creature& creature, const uint32&
         return true;
     }
 
-    if (creature.movespline->Finalized())
+    if (PathFinder* path = i_pathRequest.TakeResult(creature))
+    {
+        _moveByPath(creature, *path);
+        delete path;
+    }
+
+    if (creature.movespline->Finalized() && !i_pathRequest.IsPending())
     {
         i_nextMoveTime.Update(diff);
         if (i_nextMoveTime.Passed())
@@ -20,6 +20,7 @@
 #define MANGOS_RANDOMMOTIONGENERATOR_H
 
 #include "MovementGenerator.h"
+#include "PathRequestService.h"
 
 template<class T>
 class MANGOS_DLL_SPEC RandomMovementGenerator
@@ -38,10 +39,13 @@ class MANGOS_DLL_SPEC RandomMovementGenerator
         bool Update(T&, const uint32&);
         MovementGeneratorType GetMovementGeneratorType() const override { return RANDOM_MOTION_TYPE; }
     private:
+        void _moveByPath(T&, PathFinder&);
+
         ShortTimeTracker i_nextMoveTime;
         float i_x, i_y, i_z;
         float i_radius;
         float i_verticalZ;
+        PathRequestHandle i_pathRequest;
 };
 
 #endif
@@ -684,6 +684,8 @@ void Spell::FillTargetMap()
             }
         }
 
+        PrepareTargetsLineOfSight(tmpUnitLists[effToIndex[i]], SpellEffectIndex(i));
+
         for (UnitList::iterator itr = tmpUnitLists[effToIndex[i]].begin(); itr != tmpUnitLists[effToIndex[i]].end();)
         {
             if (!CheckTarget(*itr, SpellEffectIndex(i)))
@@ -695,11 +697,71 @@ void Spell::FillTargetMap()
                 ++itr;
         }
 
+        m_targetsLineOfSight.clear();
+
         for (UnitList::const_iterator iunit = tmpUnitLists[effToIndex[i]].begin(); iunit != tmpUnitLists[effToIndex[i]].end(); ++iunit)
             AddUnitTarget((*iunit), SpellEffectIndex(i));
     }
 }
 
+// area targets are checked against the same casting object, test all their lines of sight in one go
+void Spell::PrepareTargetsLineOfSight(UnitList const& targets, SpellEffectIndex eff)
+{
+    if (targets.size() < 2 || m_spellInfo->HasAttribute(SPELL_ATTR_EX2_IGNORE_LOS))
+        return;
+
+    // these have their own line of sight handling in CheckTarget
+    switch (m_spellInfo->Effect[eff])
+    {
+        case SPELL_EFFECT_SUMMON_PLAYER:
+        case SPELL_EFFECT_DUMMY:
+        case SPELL_EFFECT_RESURRECT_NEW:
+            return;
+        default:
+            break;
+    }
+
+    WorldObject* caster = GetCastingObject();
+    if (!caster)
+        return;
+
+    float x, y, z;
+    caster->GetPosition(x, y, z);
+
+    std::vector<VMAP::LineOfSightQuery> queries;
+    std::vector<Unit const*> queryTargets;
+    queries.reserve(targets.size());
+    queryTargets.reserve(targets.size());
+
+    for (UnitList::const_iterator itr = targets.begin(); itr != targets.end(); ++itr)
+    {
+        Unit const* target = *itr;
+        if (target == m_caster || !target->IsInMap(caster))
+            continue;
+
+        // same direction as WorldObject::IsWithinLOSInMap
+        VMAP::LineOfSightQuery query;
+        target->GetPosition(query.srcX, query.srcY, query.srcZ);
+        query.srcZ += 2.0f;
+        query.destX = x;
+        query.destY = y;
+        query.destZ = z + 2.0f;
+        query.phaseMask = target->GetPhaseMask();
+        query.result = false;
+
+        queries.push_back(query);
+        queryTargets.push_back(target);
+    }
+
+    if (queries.size() < 2)
+        return;
+
+    caster->GetMap()->IsInLineOfSight(&queries[0], queries.size());
+
+    for (uint32 i = 0; i < queries.size(); ++i)
+        m_targetsLineOfSight[queryTargets[i]] = queries[i].result;
+}
+
 void Spell::prepareDataForTriggerSystem()
 {
     //==========================================================================================
@@ -7051,6 +7113,15 @@ CurrentSpellTypes Spell::GetCurrentContainer()
         return(CURRENT_GENERIC_SPELL);
 }
 
+bool Spell::IsTargetInLineOfSight(Unit* target, WorldObject* caster) const
+{
+    UNORDERED_MAP<Unit const*, bool>::const_iterator itr = m_targetsLineOfSight.find(target);
+    if (itr != m_targetsLineOfSight.end())
+        return itr->second;
+
+    return target->IsWithinLOSInMap(caster);
+}
+
 bool Spell::CheckTarget(Unit* target, SpellEffectIndex eff)
 {
     // Check targets for creature type mask and remove not appropriate (skip explicit self target case, maybe need other explicit targets)
@@ -7130,7 +7201,7 @@ bool Spell::CheckTarget(Unit* target, SpellEffectIndex eff)
             // Get GO cast coordinates if original caster -> GO
             if (target != m_caster)
                 if (WorldObject* caster = GetCastingObject())
-                    if (!m_spellInfo->HasAttribute(SPELL_ATTR_EX2_IGNORE_LOS) && !target->IsWithinLOSInMap(caster))
+                    if (!m_spellInfo->HasAttribute(SPELL_ATTR_EX2_IGNORE_LOS) && !IsTargetInLineOfSight(target, caster))
                         return false;
             break;
     }
@@ -411,6 +411,7 @@ class Spell
         template<typename T> WorldObject* FindCorpseUsing();
 
         bool CheckTarget(Unit* target, SpellEffectIndex eff);
+        bool IsTargetInLineOfSight(Unit* target, WorldObject* caster) const;
         bool CanAutoCast(Unit* target);
 
         static void MANGOS_DLL_SPEC SendCastResult(Player* caster, SpellEntry const* spellInfo, uint8 cast_count, SpellCastResult result, bool isPetCastResult = false);
@@ -577,6 +578,7 @@ class Spell
         // Spell target filling
         //*****************************************
         void FillTargetMap();
+        void PrepareTargetsLineOfSight(UnitList const& targets, SpellEffectIndex eff);
         void SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList& targetUnitMap);
 
         void FillAreaTargets(UnitList& targetUnitMap, float radius, SpellNotifyPushType pushType, SpellTargets spellTargets, WorldObject* originalCaster = NULL);
@@ -627,6 +629,8 @@ class Spell
         GOTargetList   m_UniqueGOTargetInfo;
         ItemTargetList m_UniqueItemInfo;
 
+        UNORDERED_MAP<Unit const*, bool> m_targetsLineOfSight; ///< batch line of sight results, only set while FillTargetMap checks the targets
+
         void AddUnitTarget(Unit* target, SpellEffectIndex effIndex);
         void AddUnitTarget(ObjectGuid unitGuid, SpellEffectIndex effIndex);
         void AddGOTarget(GameObject* target, SpellEffectIndex effIndex);
@@ -1379,6 +1379,7 @@ struct DoSpellProcItemEnchant
 void SpellMgr::LoadSpellProcItemEnchant()
 {
     mSpellProcItemEnchantMap.clear();                       // need for reload case
+    mSpellProcItemEnchantTable.Clear();
 
     uint32 count = 0;
 
@@ -1435,6 +1436,8 @@ void SpellMgr::LoadSpellProcItemEnchant()
 
     delete result;
 
+    mSpellProcItemEnchantTable.Build(mSpellProcItemEnchantMap);
+
     sLog.outString();
     sLog.outString(">> Loaded %u proc item enchant definitions", count);
 }
@@ -1703,6 +1706,7 @@ bool SpellMgr::IsSpellProcEventCanTriggeredBy(SpellProcEventEntry const* spellPr
 void SpellMgr::LoadSpellElixirs()
 {
     mSpellElixirs.clear();                                  // need for reload case
+    mSpellElixirTable.Clear();
 
     uint32 count = 0;
 
@@ -1746,6 +1750,8 @@ void SpellMgr::LoadSpellElixirs()
 
     delete result;
 
+    mSpellElixirTable.Build(mSpellElixirs);
+
     sLog.outString();
     sLog.outString(">> Loaded %u spell elixir definitions", count);
 }
@@ -1806,6 +1812,7 @@ struct DoSpellThreat
 void SpellMgr::LoadSpellThreats()
 {
     mSpellThreatMap.clear();                                // need for reload case
+    mSpellThreatTable.Clear();
 
     //                                                0      1       2           3
     QueryResult* result = WorldDatabase.Query("SELECT entry, Threat, multiplier, ap_bonus FROM spell_threat");
@@ -1843,6 +1850,8 @@ void SpellMgr::LoadSpellThreats()
 
     delete result;
 
+    mSpellThreatTable.Build(mSpellThreatMap);
+
     sLog.outString();
     sLog.outString(">> Loaded %u spell threat entries", rankHelper.worker.count);
 }
@@ -2765,6 +2774,7 @@ void SpellMgr::LoadSpellChains()
 {
     mSpellChains.clear();                                   // need for reload case
     mSpellChainsNext.clear();                               // need for reload case
+    mSpellChainTable.Clear();
 
     // load known data for talents
     for (unsigned int i = 0; i < sTalentStore.GetNumRows(); ++i)
@@ -2885,6 +2895,7 @@ void SpellMgr::LoadSpellChains()
         sLog.outString();
         sLog.outString(">> Loaded 0 spell chain records");
         sLog.outErrorDb("`spell_chains` table is empty!");
+        mSpellChainTable.Build(mSpellChains);
         return;
     }
 
@@ -3126,6 +3137,8 @@ void SpellMgr::LoadSpellChains()
         }
     }
 
+    mSpellChainTable.Build(mSpellChains);
+
     sLog.outString();
     sLog.outString(">> Loaded %u spell chain records (%u from DBC data with %u req field updates, and %u loaded from table)", dbc_count + new_count, dbc_count, req_count, new_count);
 }
@@ -3171,7 +3184,10 @@ void SpellMgr::LoadSpellLearnSkills()
 
 void SpellMgr::LoadSpellLearnSpells()
 {
-    mSpellLearnSpells.clear();                              // need for reload case
+    mSpellLearnSpells.Clear();                              // need for reload case
+
+    typedef std::multimap<uint32, SpellLearnSpellNode> SpellLearnSpellLoadMap;
+    SpellLearnSpellLoadMap learnSpells;
 
     //                                                0      1        2
     QueryResult* result = WorldDatabase.Query("SELECT entry, SpellID, Active FROM spell_learn_spell");
@@ -3219,7 +3235,7 @@ void SpellMgr::LoadSpellLearnSpells()
             continue;
         }
 
-        mSpellLearnSpells.insert(SpellLearnSpellMap::value_type(spell_id, node));
+        learnSpells.insert(SpellLearnSpellLoadMap::value_type(spell_id, node));
 
         ++count;
     }
@@ -3253,10 +3269,10 @@ void SpellMgr::LoadSpellLearnSpells()
                 // other required explicit dependent learning
                 dbc_node.autoLearned = entry->EffectImplicitTargetA[i] == TARGET_PET || GetTalentSpellCost(spell) > 0 || IsPassiveSpell(entry) || IsSpellHaveEffect(entry, SPELL_EFFECT_SKILL_STEP);
 
-                SpellLearnSpellMapBounds db_node_bounds = GetSpellLearnSpellMapBounds(spell);
+                std::pair<SpellLearnSpellLoadMap::const_iterator, SpellLearnSpellLoadMap::const_iterator> db_node_bounds = learnSpells.equal_range(spell);
 
                 bool found = false;
-                for (SpellLearnSpellMap::const_iterator itr = db_node_bounds.first; itr != db_node_bounds.second; ++itr)
+                for (SpellLearnSpellLoadMap::const_iterator itr = db_node_bounds.first; itr != db_node_bounds.second; ++itr)
                 {
                     if (itr->second.spell == dbc_node.spell)
                     {
@@ -3269,13 +3285,15 @@ void SpellMgr::LoadSpellLearnSpells()
 
                 if (!found)                                 // add new spell-spell pair if not found
                 {
-                    mSpellLearnSpells.insert(SpellLearnSpellMap::value_type(spell, dbc_node));
+                    learnSpells.insert(SpellLearnSpellLoadMap::value_type(spell, dbc_node));
                     ++dbc_count;
                 }
             }
         }
     }
 
+    mSpellLearnSpells.Build(learnSpells);
+
     sLog.outString();
     sLog.outString(">> Loaded %u spell learn spells + %u found in DBC", count, dbc_count);
 }
@@ -3742,7 +3760,12 @@ bool SpellMgr::IsSpellValid(SpellEntry const* spellInfo, Player* pl, bool msg)
 void SpellMgr::LoadSpellAreas()
 {
     mSpellAreaMap.clear();                                  // need for reload case
-    mSpellAreaForAuraMap.clear();
+    mSpellAreaForAuraMap.Clear();
+    mSpellAreaForAreaMap.Clear();
+
+    typedef std::multimap<uint32, SpellArea const*> SpellAreaForLoadMap;
+    SpellAreaForLoadMap spellAreaForArea;
+    SpellAreaForLoadMap spellAreaForAura;
 
     uint32 count = 0;
 
@@ -3894,8 +3917,8 @@ void SpellMgr::LoadSpellAreas()
             if (spellArea.autocast && spellArea.auraSpell > 0)
             {
                 bool chain = false;
-                SpellAreaForAuraMapBounds saBound = GetSpellAreaForAuraMapBounds(spellArea.spellId);
-                for (SpellAreaForAuraMap::const_iterator itr = saBound.first; itr != saBound.second; ++itr)
+                std::pair<SpellAreaForLoadMap::const_iterator, SpellAreaForLoadMap::const_iterator> saBound = spellAreaForAura.equal_range(spellArea.spellId);
+                for (SpellAreaForLoadMap::const_iterator itr = saBound.first; itr != saBound.second; ++itr)
                 {
                     if (itr->second->autocast && itr->second->auraSpell > 0)
                     {
@@ -3932,11 +3955,11 @@ void SpellMgr::LoadSpellAreas()
 
         // for search by current zone/subzone at zone/subzone change
         if (spellArea.areaId)
-            mSpellAreaForAreaMap.insert(SpellAreaForAreaMap::value_type(spellArea.areaId, sa));
+            spellAreaForArea.insert(SpellAreaForLoadMap::value_type(spellArea.areaId, sa));
 
         // for search at aura apply
         if (spellArea.auraSpell)
-            mSpellAreaForAuraMap.insert(SpellAreaForAuraMap::value_type(abs(spellArea.auraSpell), sa));
+            spellAreaForAura.insert(SpellAreaForLoadMap::value_type(abs(spellArea.auraSpell), sa));
 
         ++count;
     }
@@ -3944,6 +3967,9 @@ void SpellMgr::LoadSpellAreas()
 
     delete result;
 
+    mSpellAreaForAreaMap.Build(spellAreaForArea);
+    mSpellAreaForAuraMap.Build(spellAreaForAura);
+
     sLog.outString();
     sLog.outString(">> Loaded %u spell area requirements", count);
 }
@@ -28,6 +28,7 @@
 #include "DBCStructure.h"
 
 #include "Utilities/UnorderedMapSet.h"
+#include "Utilities/DenseIdMap.h"
 
 #include <map>
 
@@ -812,11 +813,12 @@ struct SpellArea
 };
 
 typedef std::multimap<uint32 /*applySpellId*/, SpellArea> SpellAreaMap;
-typedef std::multimap<uint32 /*auraSpellId*/, SpellArea const*> SpellAreaForAuraMap;
-typedef std::multimap<uint32 /*areaOrZoneId*/, SpellArea const*> SpellAreaForAreaMap;
+// looked up at each aura apply and remove by auraSpellId and at each zone or area change by areaOrZoneId
+typedef DenseIdMultimap<SpellArea const*> SpellAreaForAuraMap;
+typedef DenseIdMultimap<SpellArea const*> SpellAreaForAreaMap;
 typedef std::pair<SpellAreaMap::const_iterator, SpellAreaMap::const_iterator> SpellAreaMapBounds;
-typedef std::pair<SpellAreaForAuraMap::const_iterator, SpellAreaForAuraMap::const_iterator>  SpellAreaForAuraMapBounds;
-typedef std::pair<SpellAreaForAreaMap::const_iterator, SpellAreaForAreaMap::const_iterator>  SpellAreaForAreaMapBounds;
+typedef SpellAreaForAuraMap::Bounds SpellAreaForAuraMapBounds;
+typedef SpellAreaForAreaMap::Bounds SpellAreaForAreaMapBounds;
 
 
 // Spell rank chain  (accessed using SpellMgr functions)
@@ -849,8 +851,8 @@ struct SpellLearnSpellNode
     bool autoLearned;
 };
 
-typedef std::multimap<uint32, SpellLearnSpellNode> SpellLearnSpellMap;
-typedef std::pair<SpellLearnSpellMap::const_iterator, SpellLearnSpellMap::const_iterator> SpellLearnSpellMapBounds;
+typedef DenseIdMultimap<SpellLearnSpellNode> SpellLearnSpellMap;
+typedef SpellLearnSpellMap::Bounds SpellLearnSpellMapBounds;
 
 typedef std::multimap<uint32, SkillLineAbilityEntry const*> SkillLineAbilityMap;
 typedef std::pair<SkillLineAbilityMap::const_iterator, SkillLineAbilityMap::const_iterator> SkillLineAbilityMapBounds;
@@ -904,11 +906,10 @@ class SpellMgr
 
         uint32 GetSpellElixirMask(uint32 spellid) const
         {
-            SpellElixirMap::const_iterator itr = mSpellElixirs.find(spellid);
-            if (itr == mSpellElixirs.end())
-                return 0x0;
+            if (uint8 const* mask = mSpellElixirTable.Find(spellid))
+                return *mask;
 
-            return itr->second;
+            return 0x0;
         }
 
         SpellSpecific GetSpellElixirSpecific(uint32 spellid) const
@@ -930,11 +931,7 @@ class SpellMgr
 
         SpellThreatEntry const* GetSpellThreatEntry(uint32 spellid) const
         {
-            SpellThreatMap::const_iterator itr = mSpellThreatMap.find(spellid);
-            if (itr != mSpellThreatMap.end())
-                return &itr->second;
-
-            return NULL;
+            return mSpellThreatTable.Find(spellid);
         }
 
         float GetSpellThreatMultiplier(SpellEntry const* spellInfo) const
@@ -957,14 +954,22 @@ class SpellMgr
             return NULL;
         }
 
+        // proc flags of the spell proc event or else of the spell, 0 for auras that never proc
+        uint32 GetSpellProcFlags(SpellEntry const* spellInfo) const
+        {
+            SpellProcEventEntry const* spellProcEvent = GetSpellProcEvent(spellInfo->Id);
+            if (spellProcEvent && spellProcEvent->procFlags)
+                return spellProcEvent->procFlags;
+            return spellInfo->procFlags;
+        }
+
         // Spell procs from item enchants
         float GetItemEnchantProcChance(uint32 spellid) const
         {
-            SpellProcItemEnchantMap::const_iterator itr = mSpellProcItemEnchantMap.find(spellid);
-            if (itr == mSpellProcItemEnchantMap.end())
-                return 0.0f;
+            if (float const* ppmRate = mSpellProcItemEnchantTable.Find(spellid))
+                return *ppmRate;
 
-            return itr->second;
+            return 0.0f;
         }
 
         static bool IsSpellProcEventCanTriggeredBy(SpellProcEventEntry const* spellProcEvent, uint32 EventProcFlag, SpellEntry const* procSpell, uint32 procFlags, uint32 procExtra);
@@ -992,11 +997,7 @@ class SpellMgr
         // Spell ranks chains
         SpellChainNode const* GetSpellChainNode(uint32 spell_id) const
         {
-            SpellChainMap::const_iterator itr = mSpellChains.find(spell_id);
-            if (itr == mSpellChains.end())
-                return NULL;
-
-            return &itr->second;
+            return mSpellChainTable.Find(spell_id);
         }
 
         uint32 GetFirstSpellInChain(uint32 spell_id) const
@@ -1040,17 +1041,17 @@ class SpellMgr
 
         uint8 IsHighRankOfSpell(uint32 spell1, uint32 spell2) const
         {
-            SpellChainMap::const_iterator itr = mSpellChains.find(spell1);
+            SpellChainNode const* node = GetSpellChainNode(spell1);
 
             uint32 rank2 = GetSpellRank(spell2);
 
             // not ordered correctly by rank value
-            if (itr == mSpellChains.end() || !rank2 || itr->second.rank <= rank2)
+            if (!node || !rank2 || node->rank <= rank2)
                 return false;
 
             // check present in same rank chain
-            for (; itr != mSpellChains.end(); itr = mSpellChains.find(itr->second.prev))
-                if (itr->second.prev == spell2)
+            for (; node; node = GetSpellChainNode(node->prev))
+                if (node->prev == spell2)
                     return true;
 
             return false;
@@ -1078,7 +1079,7 @@ class SpellMgr
 
         bool IsSpellLearnSpell(uint32 spell_id) const
         {
-            return mSpellLearnSpells.find(spell_id) != mSpellLearnSpells.end();
+            return mSpellLearnSpells.count(spell_id) != 0;
         }
 
         SpellLearnSpellMapBounds GetSpellLearnSpellMapBounds(uint32 spell_id) const
@@ -1188,14 +1189,18 @@ class SpellMgr
         bool LoadPetDefaultSpells_helper(CreatureInfo const* cInfo, PetDefaultSpellsEntry& petDefSpells);
 
         SpellChainMap      mSpellChains;
+        DenseIdMap<SpellChainNode> mSpellChainTable;        // lookup copy of mSpellChains, built after loading
         SpellChainMapNext  mSpellChainsNext;
         SpellLearnSkillMap mSpellLearnSkills;
         SpellLearnSpellMap mSpellLearnSpells;
         SpellTargetPositionMap mSpellTargetPositions;
         SpellElixirMap     mSpellElixirs;
+        DenseIdMap<uint8>  mSpellElixirTable;               // lookup copy of mSpellElixirs
         SpellThreatMap     mSpellThreatMap;
+        DenseIdMap<SpellThreatEntry> mSpellThreatTable;     // lookup copy of mSpellThreatMap
         SpellProcEventMap  mSpellProcEventMap;
         SpellProcItemEnchantMap mSpellProcItemEnchantMap;
+        DenseIdMap<float>  mSpellProcItemEnchantTable;      // lookup copy of mSpellProcItemEnchantMap
         SpellBonusMap      mSpellBonusMap;
         SkillLineAbilityMap mSkillLineAbilityMap;
         SkillRaceClassInfoMap mSkillRaceClassInfoMap;
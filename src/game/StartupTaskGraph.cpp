@@ -0,0 +1,191 @@
+/**
+ * This code is part of MaNGOS. Contributor & Copyright details are in AUTHORS/THANKS.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "StartupTaskGraph.h"
+#include "Threading.h"
+#include "Timer.h"
+#include "Log.h"
+#include "Database/DatabaseEnv.h"
+
+#include <algorithm>
+
+// amount of tasks listed per stage in the report
+#define REPORT_SLOWEST_TASKS 5
+
+class StartupTaskWorker : public ACE_Based::Runnable
+{
+    public:
+        explicit StartupTaskWorker(StartupTaskGraph& graph) : m_graph(graph) {}
+
+        void run() override
+        {
+            WorldDatabase.ThreadStart();                    // let thread do safe mySQL requests
+            m_graph.WorkerLoop();
+            WorldDatabase.ThreadEnd();                      // free mySQL thread resources
+        }
+
+    private:
+        StartupTaskGraph& m_graph;
+};
+
+std::vector<StartupTaskGraph::StageTiming> StartupTaskGraph::m_report;
+
+StartupTaskGraph::StartupTaskGraph(char const* stageName) :
+    m_stageName(stageName), m_condition(m_lock), m_finished(0)
+{
+}
+
+StartupTaskGraph::~StartupTaskGraph()
+{
+    for (std::vector<Task>::iterator itr = m_tasks.begin(); itr != m_tasks.end(); ++itr)
+        delete itr->callback;
+}
+
+StartupTaskGraph::TaskId StartupTaskGraph::AddTask(char const* name, MaNGOS::ICallback* task, TaskId dep1, TaskId dep2, TaskId dep3)
+{
+    TaskId id = TaskId(m_tasks.size());
+    m_tasks.push_back(Task(name, task));
+
+    AddDependency(id, dep1);
+    AddDependency(id, dep2);
+    AddDependency(id, dep3);
+    return id;
+}
+
+StartupTaskGraph::TaskId StartupTaskGraph::AddTask(char const* name, TaskFunction func, TaskId dep1, TaskId dep2, TaskId dep3)
+{
+    return AddTask(name, new MaNGOS::_ICallback<MaNGOS::_SCallback<> >(MaNGOS::_SCallback<>(func)), dep1, dep2, dep3);
+}
+
+void StartupTaskGraph::AddDependency(TaskId task, TaskId dependency)
+{
+    if (dependency == NO_TASK)
+        return;
+
+    // also guarantees that the graph has no cycles
+    MANGOS_ASSERT(dependency >= 0 && dependency < task);
+
+    m_tasks[dependency].dependents.push_back(task);
+    ++m_tasks[task].pendingDeps;
+}
+
+void StartupTaskGraph::ExecuteTask(Task& task)
+{
+    sLog.outString("Loading %s...", task.name);
+
+    uint32 startTime = WorldTimer::getMSTime();
+    task.callback->Execute();
+    task.time = WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime());
+}
+
+void StartupTaskGraph::Run(uint32 numThreads)
+{
+    uint32 startTime = WorldTimer::getMSTime();
+
+    if (numThreads > m_tasks.size())
+        numThreads = m_tasks.size();
+
+    if (numThreads <= 1)
+    {
+        for (std::vector<Task>::iterator itr = m_tasks.begin(); itr != m_tasks.end(); ++itr)
+            ExecuteTask(*itr);
+    }
+    else
+    {
+        for (uint32 i = 0; i < m_tasks.size(); ++i)
+            if (!m_tasks[i].pendingDeps)
+                m_ready.push_back(TaskId(i));
+
+        std::vector<ACE_Based::Thread*> workers;
+        for (uint32 i = 0; i < numThreads; ++i)
+            workers.push_back(new ACE_Based::Thread(new StartupTaskWorker(*this)));
+
+        for (std::vector<ACE_Based::Thread*>::iterator itr = workers.begin(); itr != workers.end(); ++itr)
+        {
+            (*itr)->wait();
+            delete *itr;
+        }
+
+        MANGOS_ASSERT(m_finished == m_tasks.size());
+    }
+
+    StageTiming timing;
+    timing.name = m_stageName;
+    timing.threads = numThreads > 1 ? numThreads : 1;
+    timing.time = WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime());
+    timing.taskTime = 0;
+
+    for (std::vector<Task>::const_iterator itr = m_tasks.begin(); itr != m_tasks.end(); ++itr)
+    {
+        timing.taskTime += itr->time;
+        timing.slowestTasks.push_back(std::make_pair(itr->time, itr->name));
+    }
+
+    std::sort(timing.slowestTasks.rbegin(), timing.slowestTasks.rend());
+    if (timing.slowestTasks.size() > REPORT_SLOWEST_TASKS)
+        timing.slowestTasks.resize(REPORT_SLOWEST_TASKS);
+
+    m_report.push_back(timing);
+}
+
+void StartupTaskGraph::WorkerLoop()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    while (true)
+    {
+        while (m_ready.empty() && m_finished < m_tasks.size())
+            m_condition.wait();
+
+        if (m_finished == m_tasks.size())
+            return;
+
+        // lowest id first, keeps the order close to the sequential one
+        std::vector<TaskId>::iterator next = std::min_element(m_ready.begin(), m_ready.end());
+        Task& task = m_tasks[*next];
+        m_ready.erase(next);
+
+        m_lock.release();
+        ExecuteTask(task);
+        m_lock.acquire();
+
+        ++m_finished;
+        for (std::vector<TaskId>::const_iterator itr = task.dependents.begin(); itr != task.dependents.end(); ++itr)
+            if (--m_tasks[*itr].pendingDeps == 0)
+                m_ready.push_back(*itr);
+
+        m_condition.broadcast();
+    }
+}
+
+void StartupTaskGraph::PrintReport()
+{
+    sLog.outString();
+    sLog.outString("Startup loading stages:");
+
+    for (std::vector<StageTiming>::const_iterator itr = m_report.begin(); itr != m_report.end(); ++itr)
+    {
+        sLog.outString("  %s: %u ms with %u thread(s), %u ms task time", itr->name.c_str(), itr->time, itr->threads, itr->taskTime);
+
+        for (std::vector<std::pair<uint32, char const*> >::const_iterator task = itr->slowestTasks.begin(); task != itr->slowestTasks.end(); ++task)
+            sLog.outString("      %6u ms  %s", task->first, task->second);
+    }
+
+    sLog.outString();
+    m_report.clear();
+}
@@ -0,0 +1,95 @@
+/**
+ * This code is part of MaNGOS. Contributor & Copyright details are in AUTHORS/THANKS.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_STARTUPTASKGRAPH_H
+#define MANGOS_STARTUPTASKGRAPH_H
+
+#include "Common.h"
+#include "Utilities/Callback.h"
+#include "ace/Thread_Mutex.h"
+#include "ace/Condition_Thread_Mutex.h"
+
+#include <vector>
+
+/**
+ * One stage of the world server startup, a set of loading tasks with declared dependencies.
+ *
+ * Tasks are added after the tasks they depend on, so the adding order is always a valid
+ * sequential order. Run() with more than one thread starts every task as soon as its
+ * dependencies are finished, each thread using its own DB connection of the pool.
+ * A task without declared dependencies must not use data loaded by other tasks of the stage.
+ */
+class StartupTaskGraph
+{
+    public:
+        typedef int32 TaskId;
+        static const TaskId NO_TASK = -1;
+
+        typedef void (*TaskFunction)();
+
+        explicit StartupTaskGraph(char const* stageName);
+        ~StartupTaskGraph();
+
+        // the task is owned by the graph, dependencies must be added before
+        TaskId AddTask(char const* name, MaNGOS::ICallback* task, TaskId dep1 = NO_TASK, TaskId dep2 = NO_TASK, TaskId dep3 = NO_TASK);
+        TaskId AddTask(char const* name, TaskFunction func, TaskId dep1 = NO_TASK, TaskId dep2 = NO_TASK, TaskId dep3 = NO_TASK);
+
+        // runs all tasks and returns when they are finished, sequential in adding order for numThreads <= 1
+        void Run(uint32 numThreads);
+
+        // output time used by all stages run so far and their slowest tasks
+        static void PrintReport();
+
+    private:
+        friend class StartupTaskWorker;
+
+        struct Task
+        {
+            Task(char const* _name, MaNGOS::ICallback* _callback) : name(_name), callback(_callback), pendingDeps(0), time(0) {}
+
+            char const* name;
+            MaNGOS::ICallback* callback;
+            std::vector<TaskId> dependents;                 ///< tasks waiting for this one
+            uint32 pendingDeps;                             ///< dependencies not yet finished, only used while running
+            uint32 time;
+        };
+
+        void AddDependency(TaskId task, TaskId dependency);
+        void ExecuteTask(Task& task);
+        void WorkerLoop();
+
+        char const* m_stageName;
+        std::vector<Task> m_tasks;
+
+        ACE_Thread_Mutex m_lock;
+        ACE_Condition_Thread_Mutex m_condition;             ///< signaled when a task finished
+        std::vector<TaskId> m_ready;                        ///< tasks with all dependencies finished, in adding order
+        uint32 m_finished;
+
+        struct StageTiming
+        {
+            std::string name;
+            uint32 threads;
+            uint32 time;                                    ///< wall clock time of the stage
+            uint32 taskTime;                                ///< sum of the task times
+            std::vector<std::pair<uint32, char const*> > slowestTasks;
+        };
+        static std::vector<StageTiming> m_report;
+};
+
+#endif
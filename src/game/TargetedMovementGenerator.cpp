@@ -71,13 +71,33 @@ void TargetedMovementGeneratorMedium<T, D>::_setTargetLocation(T& owner, bool up
         z = end.z;
     }
 
-    if (!i_path)
-        i_path = new PathFinder(&owner);
-
     // allow pets following their master to cheat while generating paths
     bool forceDest = (owner.GetTypeId() == TYPEID_UNIT && ((Creature*)&owner)->IsPet()
                       && owner.hasUnitState(UNIT_STAT_FOLLOW));
+
+    // the path is calculated already, a request still waiting for a thread is given the new destination
+    if (i_pathRequest.IsPending())
+    {
+        i_pathRequest.UpdateDestination(x, y, z, forceDest);
+        return;
+    }
+
+    if (!i_path)
+        i_path = new PathFinder(&owner);
+
+    if (i_pathRequest.Request(i_path, x, y, z, forceDest))
+    {
+        i_path = NULL;                                      // back with the result in Update()
+        return;
+    }
+
     i_path->calculate(x, y, z, forceDest);
+    _moveByPath(owner);
+}
+
+template<class T, typename D>
+void TargetedMovementGeneratorMedium<T, D>::_moveByPath(T& owner)
+{
     if (i_path->getPathType() & PATHFIND_NOPATH)
         return;
 
@@ -127,6 +147,16 @@ bool TargetedMovementGeneratorMedium<T, D>::Update(T& owner, const uint32& time_
         return true;
     }
 
+    if (PathFinder* path = i_pathRequest.TakeResult(owner))
+    {
+        i_path = path;
+        _moveByPath(owner);
+    }
+
+    // old movement continues until the path is calculated, the target is not reached by it
+    if (i_pathRequest.IsPending())
+        return true;
+
     bool targetMoved = false;
     i_recheckDistance.Update(time_diff);
     if (i_recheckDistance.Passed())
@@ -163,6 +193,7 @@ bool TargetedMovementGeneratorMedium<T, D>::Update(T& owner, const uint32& time_
 template<class T, typename D>
 bool TargetedMovementGeneratorMedium<T, D>::IsReachable() const
 {
+    // not known yet while the path is calculated
     return (i_path) ? (i_path->getPathType() & PATHFIND_NORMAL) : true;
 }
 
@@ -204,12 +235,14 @@ void ChaseMovementGenerator<Creature>::Initialize(Creature& owner)
 template<class T>
 void ChaseMovementGenerator<T>::Finalize(T& owner)
 {
+    this->i_pathRequest.Cancel();
     owner.clearUnitState(UNIT_STAT_CHASE | UNIT_STAT_CHASE_MOVE);
 }
 
 template<class T>
 void ChaseMovementGenerator<T>::Interrupt(T& owner)
 {
+    this->i_pathRequest.Cancel();
     owner.InterruptMoving();
     owner.clearUnitState(UNIT_STAT_CHASE | UNIT_STAT_CHASE_MOVE);
 }
@@ -275,6 +308,7 @@ void FollowMovementGenerator<Creature>::Initialize(Creature& owner)
 template<class T>
 void FollowMovementGenerator<T>::Finalize(T& owner)
 {
+    this->i_pathRequest.Cancel();
     owner.clearUnitState(UNIT_STAT_FOLLOW | UNIT_STAT_FOLLOW_MOVE);
     _updateSpeed(owner);
 }
@@ -282,6 +316,7 @@ void FollowMovementGenerator<T>::Finalize(T& owner)
 template<class T>
 void FollowMovementGenerator<T>::Interrupt(T& owner)
 {
+    this->i_pathRequest.Cancel();
     owner.InterruptMoving();
     owner.clearUnitState(UNIT_STAT_FOLLOW | UNIT_STAT_FOLLOW_MOVE);
     _updateSpeed(owner);
@@ -21,6 +21,7 @@
 
 #include "MovementGenerator.h"
 #include "FollowerReference.h"
+#include "PathRequestService.h"
 
 class PathFinder;
 
@@ -59,6 +60,7 @@ class MANGOS_DLL_SPEC TargetedMovementGeneratorMedium
 
     protected:
         void _setTargetLocation(T&, bool updateDestination);
+        void _moveByPath(T&);
 
         ShortTimeTracker i_recheckDistance;
         float i_offset;
@@ -67,6 +69,7 @@ class MANGOS_DLL_SPEC TargetedMovementGeneratorMedium
         bool i_targetReached : 1;
 
         PathFinder* i_path;
+        PathRequestHandle i_pathRequest;                    // i_path is NULL while it is calculated by a path thread
 };
 
 template<class T>
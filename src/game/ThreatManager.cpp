@@ -217,6 +217,15 @@ void ThreatContainer::clearReferences()
     iThreatList.clear();
 }
 
+//============================================================
+
+void ThreatContainer::remove(HostileReference* pRef)
+{
+    ThreatList::iterator itr = std::find(iThreatList.begin(), iThreatList.end(), pRef);
+    if (itr != iThreatList.end())
+        iThreatList.erase(itr);
+}
+
 //============================================================
 // Return the HostileReference of NULL, if not found
 HostileReference* ThreatContainer::getReferenceByTarget(Unit* pVictim)
@@ -272,12 +281,24 @@ bool HostileReferenceSortPredicate(const HostileReference* lhs, const HostileRef
 
 //============================================================
 // Check if the list is dirty and sort if necessary
+// Between two updates usually only a few references change their threat, so the list is still
+// almost sorted and an insertion sort puts them in place in about linear time
 
 void ThreatContainer::update()
 {
     if (iDirty && iThreatList.size() > 1)
     {
-        iThreatList.sort(HostileReferenceSortPredicate);
+        for (ThreatList::iterator itr = iThreatList.begin() + 1; itr != iThreatList.end(); ++itr)
+        {
+            HostileReference* pRef = *itr;
+
+            // references of the same threat keep their order
+            ThreatList::iterator pos = itr;
+            for (; pos != iThreatList.begin() && HostileReferenceSortPredicate(pRef, *(pos - 1)); --pos)
+                *pos = *(pos - 1);
+
+            *pos = pRef;
+        }
     }
     iDirty = false;
 }
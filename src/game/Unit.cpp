@@ -51,6 +51,7 @@
 #include "movement/MoveSplineInit.h"
 #include "movement/MoveSpline.h"
 #include "CreatureLinkingMgr.h"
+#include "ace/Atomic_Op.h"
 
 #include <math.h>
 #include <stdarg.h>
@@ -314,6 +315,7 @@ void Unit::Update(uint32 update_diff, uint32 p_time)
     _UpdateSpells(update_diff);
 
     CleanupDeletedAuras();
+    CompactModAuraLists();
 
     if (m_lastManaUseTimer)
     {
@@ -4255,6 +4257,15 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
     holder->_AddSpellAuraHolder();
     m_spellAuraHolders.insert(SpellAuraHolderMap::value_type(holder->GetId(), holder));
 
+    if (uint32 procFlags = sSpellMgr.GetSpellProcFlags(holder->GetSpellProto()))
+    {
+        // after the holders of the same spell, as in the holder map
+        ProcTriggerHolderList::iterator pos = m_procTriggerHolders.begin();
+        while (pos != m_procTriggerHolders.end() && pos->spellId <= holder->GetId())
+            ++pos;
+        m_procTriggerHolders.insert(pos, ProcTriggerHolder(holder, holder->GetId(), procFlags));
+    }
+
     for (int32 i = 0; i < MAX_EFFECT_INDEX; ++i)
         if (Aura* aur = holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
             AddAuraToModList(aur);
@@ -4862,6 +4873,15 @@ void Unit::RemoveSpellAuraHolder(SpellAuraHolder* holder, AuraRemoveMode mode)
         }
     }
 
+    for (ProcTriggerHolderList::iterator itr = m_procTriggerHolders.begin(); itr != m_procTriggerHolders.end(); ++itr)
+    {
+        if (itr->holder == holder)
+        {
+            m_procTriggerHolders.erase(itr);
+            break;
+        }
+    }
+
     holder->SetRemoveMode(mode);
     holder->UnregisterAndCleanupTrackedAuras();
 
@@ -4913,7 +4933,8 @@ void Unit::RemoveAura(Aura* Aur, AuraRemoveMode mode)
     // remove from list before mods removing (prevent cyclic calls, mods added before including to aura list - use reverse order)
     if (Aur->GetModifier()->m_auraname < TOTAL_AURAS)
     {
-        m_modAuras[Aur->GetModifier()->m_auraname].remove(Aur);
+        if (m_modAuras[Aur->GetModifier()->m_auraname].remove(Aur))
+            m_gappedModAuraTypes.push_back(Aur->GetModifier()->m_auraname);
     }
 
     // Set remove mode
@@ -8356,19 +8377,18 @@ void Unit::UpdateVisibilityAndView()
     static const AuraType auratypes[] = {SPELL_AURA_BIND_SIGHT, SPELL_AURA_FAR_SIGHT, SPELL_AURA_NONE};
     for (AuraType const* type = &auratypes[0]; *type != SPELL_AURA_NONE; ++type)
     {
-        AuraList& alist = m_modAuras[*type];
+        AuraList const& alist = m_modAuras[*type];
         if (alist.empty())
             continue;
 
-        for (AuraList::iterator it = alist.begin(); it != alist.end();)
+        for (AuraList::const_iterator it = alist.begin(); it != alist.end();)
         {
             Aura* aura = (*it);
             Unit* owner = aura->GetCaster();
 
             if (!owner || !isVisibleForOrDetect(owner, this, false))
             {
-                alist.erase(it);
-                RemoveAura(aura);
+                RemoveAura(aura);                           // removes it from the list first
                 it = alist.begin();
             }
             else
@@ -9635,8 +9655,8 @@ void Unit::ApplyAuraProcTriggerDamage(Aura* aura, bool apply)
     AuraList& tAuraProcTriggerDamage = m_modAuras[SPELL_AURA_PROC_TRIGGER_DAMAGE];
     if (apply)
         tAuraProcTriggerDamage.push_back(aura);
-    else
-        tAuraProcTriggerDamage.remove(aura);
+    else if (tAuraProcTriggerDamage.remove(aura))
+        m_gappedModAuraTypes.push_back(SPELL_AURA_PROC_TRIGGER_DAMAGE);
 }
 
 uint32 Unit::GetCreatePowers(Powers power) const
@@ -9946,6 +9966,29 @@ struct ProcTriggeredData
 typedef std::list< ProcTriggeredData > ProcTriggeredList;
 typedef std::list< uint32> RemoveSpellList;
 
+typedef ACE_Atomic_Op<ACE_Thread_Mutex, long> ProcStatCounter;
+static ProcStatCounter s_procCalls;
+static ProcStatCounter s_procHolders;
+static ProcStatCounter s_procChecks;
+
+UnitProcStats Unit::GetProcStats(bool reset)
+{
+    UnitProcStats stats;
+    stats.procs = uint32(s_procCalls.value());
+    stats.holders = uint32(s_procHolders.value());
+    stats.checks = uint32(s_procChecks.value());
+
+    // counts added meanwhile are kept for the next stats
+    if (reset)
+    {
+        s_procCalls -= long(stats.procs);
+        s_procHolders -= long(stats.holders);
+        s_procChecks -= long(stats.checks);
+    }
+
+    return stats;
+}
+
 uint32 createProcExtendMask(SpellNonMeleeDamage* damageInfo, SpellMissInfo missCondition)
 {
     uint32 procEx = PROC_EX_NONE;
@@ -10054,21 +10097,33 @@ void Unit::ProcDamageAndSpellFor(bool isVictim, Unit* pTarget, uint32 procFlag,
 
     RemoveSpellList removedSpells;
     ProcTriggeredList procTriggered;
-    // Fill procTriggered list
-    for (SpellAuraHolderMap::const_iterator itr = GetSpellAuraHolderMap().begin(); itr != GetSpellAuraHolderMap().end(); ++itr)
+    // Fill procTriggered list, only holders that can proc on one of the flags are checked
+    uint32 checks = 0;
+    for (size_t i = 0; i < m_procTriggerHolders.size(); ++i)
     {
+        if (!(m_procTriggerHolders[i].procFlags & procFlag))
+            continue;
+
+        SpellAuraHolder* holder = m_procTriggerHolders[i].holder;
+
         // skip deleted auras (possible at recursive triggered call
-        if (itr->second->IsDeleted())
+        if (holder->IsDeleted())
             continue;
 
+        ++checks;
+
         SpellProcEventEntry const* spellProcEvent = NULL;
-        if (!IsTriggeredAtSpellProcEvent(pTarget, itr->second, procSpell, procFlag, procExtra, attType, isVictim, spellProcEvent))
+        if (!IsTriggeredAtSpellProcEvent(pTarget, holder, procSpell, procFlag, procExtra, attType, isVictim, spellProcEvent))
             continue;
 
-        itr->second->SetInUse(true);                        // prevent holder deletion
-        procTriggered.push_back(ProcTriggeredData(spellProcEvent, itr->second));
+        holder->SetInUse(true);                             // prevent holder deletion
+        procTriggered.push_back(ProcTriggeredData(spellProcEvent, holder));
     }
 
+    ++s_procCalls;
+    s_procHolders += long(m_spellAuraHolders.size());
+    s_procChecks += long(checks);
+
     // Nothing found
     if (procTriggered.empty())
         return;
@@ -11021,6 +11076,34 @@ void Unit::CleanupDeletedAuras()
     m_deletedAuras.clear();
 }
 
+void Unit::CompactModAuraLists()
+{
+    for (std::vector<AuraType>::const_iterator itr = m_gappedModAuraTypes.begin(); itr != m_gappedModAuraTypes.end(); ++itr)
+        m_modAuras[*itr].Compact();
+    m_gappedModAuraTypes.clear();
+}
+
+bool ModAuraList::remove(Aura* aura)
+{
+    bool hadGaps = HasGaps();
+
+    for (Slots::iterator itr = m_slots.begin(); itr != m_slots.end(); ++itr)
+    {
+        if (*itr == aura)
+        {
+            *itr = NULL;
+            --m_count;
+        }
+    }
+
+    return !hadGaps && HasGaps();
+}
+
+void ModAuraList::Compact()
+{
+    m_slots.erase(std::remove(m_slots.begin(), m_slots.end(), (Aura*)NULL), m_slots.end());
+}
+
 bool Unit::CheckAndIncreaseCastCounter()
 {
     uint32 maxCasts = sWorld.getConfig(CONFIG_UINT32_MAX_SPELL_CASTS_IN_CHAIN);
@@ -43,6 +43,8 @@
 #include "WorldPacket.h"
 #include "Timer.h"
 #include <list>
+#include <vector>
+#include <iterator>
 
 enum SpellInterruptFlags
 {
@@ -1183,6 +1185,111 @@ enum IgnoreUnitState
 #define REGEN_TIME_FULL     2000                            // For this time difference is computed regen value
 #define REGEN_TIME_PRECISE  500                             // Used in Spell::CheckPower for precise regeneration in spell cast time
 
+/**
+ * Auras of one aura type on a unit, in the order they were applied.
+ *
+ * The auras are kept in one array, walking them doesn't chase list nodes. Removing an aura only
+ * clears its slot, so loops over the list that remove auras keep valid iterators, the iterators
+ * skip the cleared slots. The owner closes the gaps with Compact() when no loop can be running.
+ */
+class ModAuraList
+{
+    private:
+        typedef std::vector<Aura*> Slots;
+
+    public:
+        class const_iterator : public std::iterator<std::forward_iterator_tag, Aura*, ptrdiff_t, Aura* const*, Aura* const&>
+        {
+            public:
+                const_iterator() : m_slots(NULL), m_index(0) {}
+                const_iterator(Slots const* slots, size_t index) : m_slots(slots), m_index(index) { SkipEmpty(); }
+
+                Aura* const& operator*() const { return (*m_slots)[m_index]; }
+                Aura* const* operator->() const { return &(*m_slots)[m_index]; }
+
+                const_iterator& operator++() { ++m_index; SkipEmpty(); return *this; }
+                const_iterator operator++(int) { const_iterator tmp = *this; ++*this; return tmp; }
+
+                bool operator==(const_iterator const& other) const { return m_index == other.m_index; }
+                bool operator!=(const_iterator const& other) const { return m_index != other.m_index; }
+
+            private:
+                void SkipEmpty() { while (m_index < m_slots->size() && !(*m_slots)[m_index]) ++m_index; }
+
+                Slots const* m_slots;
+                size_t m_index;
+        };
+
+        class const_reverse_iterator : public std::iterator<std::forward_iterator_tag, Aura*, ptrdiff_t, Aura* const*, Aura* const&>
+        {
+            public:
+                const_reverse_iterator() : m_slots(NULL), m_index(0) {}
+                const_reverse_iterator(Slots const* slots, size_t index) : m_slots(slots), m_index(index) { SkipEmpty(); }
+
+                Aura* const& operator*() const { return (*m_slots)[m_index - 1]; }
+                Aura* const* operator->() const { return &(*m_slots)[m_index - 1]; }
+
+                const_reverse_iterator& operator++() { --m_index; SkipEmpty(); return *this; }
+                const_reverse_iterator operator++(int) { const_reverse_iterator tmp = *this; ++*this; return tmp; }
+
+                bool operator==(const_reverse_iterator const& other) const { return m_index == other.m_index; }
+                bool operator!=(const_reverse_iterator const& other) const { return m_index != other.m_index; }
+
+            private:
+                void SkipEmpty() { while (m_index > 0 && !(*m_slots)[m_index - 1]) --m_index; }
+
+                Slots const* m_slots;
+                size_t m_index;                             ///< one past the slot pointed to
+        };
+
+        typedef const_iterator iterator;
+
+        ModAuraList() : m_count(0) {}
+
+        const_iterator begin() const { return const_iterator(&m_slots, 0); }
+        const_iterator end() const { return const_iterator(&m_slots, m_slots.size()); }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(&m_slots, m_slots.size()); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(&m_slots, 0); }
+
+        bool empty() const { return m_count == 0; }
+        size_t size() const { return m_count; }
+        Aura* front() const { return *begin(); }
+        Aura* back() const { return *rbegin(); }
+
+        void push_back(Aura* aura) { m_slots.push_back(aura); ++m_count; }
+        void clear() { m_slots.clear(); m_count = 0; }
+
+        // returns true if the list had no gaps before
+        bool remove(Aura* aura);
+
+        bool HasGaps() const { return m_count != m_slots.size(); }
+        void Compact();
+
+    private:
+        Slots m_slots;
+        size_t m_count;                                     ///< auras in the slots
+};
+
+// aura holder that can proc, with the proc flags it triggers on
+struct ProcTriggerHolder
+{
+    ProcTriggerHolder(SpellAuraHolder* _holder, uint32 _spellId, uint32 _procFlags)
+        : holder(_holder), spellId(_spellId), procFlags(_procFlags) {}
+
+    SpellAuraHolder* holder;
+    uint32 spellId;
+    uint32 procFlags;                                       ///< as of the holder apply, reloaded proc events apply to new holders
+};
+
+struct UnitProcStats
+{
+    UnitProcStats() : procs(0), holders(0), checks(0) {}
+
+    uint32 procs;                                           ///< ProcDamageAndSpellFor calls
+    uint32 holders;                                         ///< aura holders the units had at these calls
+    uint32 checks;                                          ///< holders checked, the ones with a matching proc flag
+};
+
 struct SpellProcEventEntry;                                 // used only privately
 
 class MANGOS_DLL_SPEC Unit : public WorldObject
@@ -1193,7 +1300,8 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
         typedef std::pair<SpellAuraHolderMap::iterator, SpellAuraHolderMap::iterator> SpellAuraHolderBounds;
         typedef std::pair<SpellAuraHolderMap::const_iterator, SpellAuraHolderMap::const_iterator> SpellAuraHolderConstBounds;
         typedef std::list<SpellAuraHolder*> SpellAuraHolderList;
-        typedef std::list<Aura*> AuraList;
+        typedef std::vector<ProcTriggerHolder> ProcTriggerHolderList;
+        typedef ModAuraList AuraList;
         typedef std::list<DiminishingReturn> Diminishing;
         typedef std::set<uint32 /*playerGuidLow*/> ComboPointHolderSet;
         typedef std::map<uint8 /*slot*/, uint32 /*spellId*/> VisibleAuraMap;
@@ -1967,6 +2075,9 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
          */
         void ProcDamageAndSpellFor(bool isVictim, Unit* pTarget, uint32 procFlag, uint32 procExtra, WeaponAttackType attType, SpellEntry const* procSpell, uint32 damage);
 
+        // proc handling of all units since the last reset
+        static UnitProcStats GetProcStats(bool reset);
+
         /** 
          * Handles an emote, for example /charge would write something
          * along the lines: "NAME begins to charge" in orange text. This
@@ -2701,6 +2812,7 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
         SpellAuraHolderMap::iterator m_spellAuraHoldersUpdateIterator; // != end() in Unit::m_spellAuraHolders update and point to next element
         AuraList m_deletedAuras;                            // auras removed while in ApplyModifier and waiting deleted
         SpellAuraHolderList m_deletedHolders;
+        ProcTriggerHolderList m_procTriggerHolders;         // holders of m_spellAuraHolders that can proc, in its order
 
         // Store Auras for which the target must be tracked
         TrackedAuraTargetMap m_trackedAuraTargets[MAX_TRACKED_AURA_TYPES];
@@ -2715,6 +2827,7 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
         uint32 m_transform;
 
         AuraList m_modAuras[TOTAL_AURAS];
+        std::vector<AuraType> m_gappedModAuraTypes;         // m_modAuras with removed auras, compacted at update
         float m_auraModifiersGroup[UNIT_MOD_END][MODIFIER_TYPE_END];
         float m_weaponDamage[MAX_ATTACK][2];
         bool m_canModifyStats;
@@ -2740,6 +2853,7 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
 
     private:
         void CleanupDeletedAuras();
+        void CompactModAuraLists();
         void UpdateSplineMovement(uint32 t_diff);
 
         // player or player's pet
@@ -25,6 +25,7 @@
 #include "World.h"
 #include "ObjectGuid.h"
 #include <zlib/zlib.h>
+#include "ace/TSS_T.h"
 
 UpdateData::UpdateData() : m_blockCount(0)
 {
@@ -46,44 +47,100 @@ void UpdateData::AddUpdateBlock(const ByteBuffer& block)
     ++m_blockCount;
 }
 
-void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
+// deflate stream kept per thread and reset for each packet, this saves the allocation
+// and initialization of the zlib state for every compressed update packet
+class UpdatePacketCompressor
+{
+    public:
+        UpdatePacketCompressor() : m_level(-1)
+        {
+            m_stream.zalloc = (alloc_func)0;
+            m_stream.zfree = (free_func)0;
+            m_stream.opaque = (voidpf)0;
+        }
+
+        ~UpdatePacketCompressor()
+        {
+            if (m_level >= 0)
+                deflateEnd(&m_stream);
+        }
+
+        // returns a stream ready for a new packet, NULL if zlib failed to initialize
+        z_stream* GetStream(int level)
+        {
+            if (m_level == level)
+            {
+                int z_res = deflateReset(&m_stream);
+                if (z_res == Z_OK)
+                    return &m_stream;
+
+                sLog.outError("Can't compress update packet (zlib: deflateReset) Error code: %i (%s)", z_res, zError(z_res));
+            }
+
+            // first use or compression level changed at config reload
+            if (m_level >= 0)
+                deflateEnd(&m_stream);
+
+            m_level = -1;
+
+            int z_res = deflateInit(&m_stream, level);
+            if (z_res != Z_OK)
+            {
+                sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
+                return NULL;
+            }
+
+            m_level = level;
+            return &m_stream;
+        }
+
+    private:
+        z_stream m_stream;
+        int m_level;                                        // level of the initialized stream, -1 if not initialized
+};
+
+static ACE_TSS<UpdatePacketCompressor> s_compressor;
+
+void UpdateData::Compress(void* dst, uint32* dst_size, ByteBuffer const& header)
 {
-    z_stream c_stream;
-
-    c_stream.zalloc = (alloc_func)0;
-    c_stream.zfree = (free_func)0;
-    c_stream.opaque = (voidpf)0;
-
     // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
-    if (z_res != Z_OK)
+    z_stream* c_stream = s_compressor->GetStream(sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
+    if (!c_stream)
     {
-        sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
         *dst_size = 0;
         return;
     }
 
-    c_stream.next_out = (Bytef*)dst;
-    c_stream.avail_out = *dst_size;
-    c_stream.next_in = (Bytef*)src;
-    c_stream.avail_in = (uInt)src_size;
-
-    z_res = deflate(&c_stream, Z_NO_FLUSH);
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflate) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
+    c_stream->next_out = (Bytef*)dst;
+    c_stream->avail_out = *dst_size;
 
-    if (c_stream.avail_in != 0)
+    // header and blocks are compressed as one stream, no need to merge them into a temporary buffer first
+    ByteBuffer const* sources[2] = { &header, &m_data };
+    for (int i = 0; i < 2; ++i)
     {
-        sLog.outError("Can't compress update packet (zlib: deflate not greedy)");
-        *dst_size = 0;
-        return;
+        if (!sources[i]->wpos())
+            continue;
+
+        c_stream->next_in = (Bytef*)sources[i]->contents();
+        c_stream->avail_in = (uInt)sources[i]->wpos();
+
+        int z_res = deflate(c_stream, Z_NO_FLUSH);
+        if (z_res != Z_OK)
+        {
+            sLog.outError("Can't compress update packet (zlib: deflate) Error code: %i (%s)", z_res, zError(z_res));
+            *dst_size = 0;
+            return;
+        }
+
+        if (c_stream->avail_in != 0)
+        {
+            sLog.outError("Can't compress update packet (zlib: deflate not greedy)");
+            *dst_size = 0;
+            return;
+        }
     }
 
-    z_res = deflate(&c_stream, Z_FINISH);
+    int z_res = deflate(c_stream, Z_FINISH);
     if (z_res != Z_STREAM_END)
     {
         sLog.outError("Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)", z_res, zError(z_res));
@@ -91,37 +148,27 @@ void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
         return;
     }
 
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
-    *dst_size = c_stream.total_out;
+    *dst_size = c_stream->total_out;
 }
 
 bool UpdateData::BuildPacket(WorldPacket* packet)
 {
     MANGOS_ASSERT(packet->empty());                         // shouldn't happen
 
-    ByteBuffer buf(4 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()) + m_data.wpos());
+    ByteBuffer header(4 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()));
 
-    buf << (uint32)(!m_outOfRangeGUIDs.empty() ? m_blockCount + 1 : m_blockCount);
+    header << (uint32)(!m_outOfRangeGUIDs.empty() ? m_blockCount + 1 : m_blockCount);
 
     if (!m_outOfRangeGUIDs.empty())
     {
-        buf << (uint8) UPDATETYPE_OUT_OF_RANGE_OBJECTS;
-        buf << (uint32) m_outOfRangeGUIDs.size();
+        header << (uint8) UPDATETYPE_OUT_OF_RANGE_OBJECTS;
+        header << (uint32) m_outOfRangeGUIDs.size();
 
         for (GuidSet::const_iterator i = m_outOfRangeGUIDs.begin(); i != m_outOfRangeGUIDs.end(); ++i)
-            buf << i->WriteAsPacked();
+            header << i->WriteAsPacked();
     }
 
-    buf.append(m_data);
-
-    size_t pSize = buf.wpos();                              // use real used data size
+    size_t pSize = header.wpos() + m_data.wpos();          // use real used data size
 
     if (pSize > 100)                                        // compress large packets
     {
@@ -129,7 +176,7 @@ bool UpdateData::BuildPacket(WorldPacket* packet)
         packet->resize(destsize + sizeof(uint32));
 
         packet->put<uint32>(0, pSize);
-        Compress(const_cast<uint8*>(packet->contents()) + sizeof(uint32), &destsize, (void*)buf.contents(), pSize);
+        Compress(const_cast<uint8*>(packet->contents()) + sizeof(uint32), &destsize, header);
         if (destsize == 0)
             return false;
 
@@ -138,7 +185,8 @@ bool UpdateData::BuildPacket(WorldPacket* packet)
     }
     else                                                    // send small packets without compression
     {
-        packet->append(buf);
+        packet->append(header);
+        packet->append(m_data);
         packet->SetOpcode(SMSG_UPDATE_OBJECT);
     }
 
@@ -68,6 +68,7 @@ class UpdateData
         GuidSet m_outOfRangeGUIDs;
         ByteBuffer m_data;
 
-        void Compress(void* dst, uint32* dst_size, void* src, int src_size);
+        // compresses header followed by m_data
+        void Compress(void* dst, uint32* dst_size, ByteBuffer const& header);
 };
 #endif
@@ -22,57 +22,98 @@
 #include "UpdateFields.h"
 #include "Errors.h"
 
+#if COMPILER == COMPILER_MICROSOFT
+#  include <intrin.h>
+#endif
+
+/**
+ * Bit mask of update fields, one bit for every field of an object.
+ *
+ * The bits are stored inline in 32 bit blocks sized for the largest object type (player),
+ * so masks can be created on the stack without any heap allocation. Set bits are found a
+ * whole block at a time, walking a mask costs time proportional to the number of set bits.
+ */
 class UpdateMask
 {
     public:
-        UpdateMask() : mCount(0), mBlocks(0), mUpdateMask(0) { }
-        UpdateMask(const UpdateMask& mask) : mUpdateMask(0) { *this = mask; }
-
-        ~UpdateMask()
+        enum
         {
-            delete[] mUpdateMask;
-        }
+            MAX_FIELDS = PLAYER_END,                        ///< players have the most update fields of all object types
+            MAX_BLOCKS = (MAX_FIELDS + 31) / 32
+        };
+
+        UpdateMask() : mCount(0), mBlocks(0) { }
+        UpdateMask(const UpdateMask& mask) { *this = mask; }
 
         void SetBit(uint32 index)
         {
-            ((uint8*)mUpdateMask)[ index >> 3 ] |= 1 << (index & 0x7);
+            mUpdateMask[index >> 5] |= uint32(1) << (index & 0x1F);
         }
 
         void UnsetBit(uint32 index)
         {
-            ((uint8*)mUpdateMask)[ index >> 3 ] &= (0xff ^ (1 << (index & 0x7)));
+            mUpdateMask[index >> 5] &= ~(uint32(1) << (index & 0x1F));
         }
 
         bool GetBit(uint32 index) const
         {
-            return (((uint8*)mUpdateMask)[ index >> 3 ] & (1 << (index & 0x7))) != 0;
+            return (mUpdateMask[index >> 5] & (uint32(1) << (index & 0x1F))) != 0;
+        }
+
+        // returns the index of the first set bit at or after index, GetCount() if there is none
+        uint32 FindNextSetBit(uint32 index) const
+        {
+            uint32 block = index >> 5;
+            if (block >= mBlocks)
+                return mCount;
+
+            // drop the bits below index in the first block
+            uint32 bits = mUpdateMask[block] & (~uint32(0) << (index & 0x1F));
+
+            while (!bits)
+            {
+                if (++block >= mBlocks)
+                    return mCount;
+
+                bits = mUpdateMask[block];
+            }
+
+            return (block << 5) + CountTrailingZeros(bits);
+        }
+
+        bool IsEmpty() const
+        {
+            for (uint32 i = 0; i < mBlocks; ++i)
+                if (mUpdateMask[i])
+                    return false;
+
+            return true;
         }
 
         uint32 GetBlockCount() const { return mBlocks; }
+        uint32 GetBlock(uint32 block) const { return mUpdateMask[block]; }
         uint32 GetLength() const { return mBlocks << 2; }
         uint32 GetCount() const { return mCount; }
-        uint8* GetMask() { return (uint8*)mUpdateMask; }
 
         void SetCount(uint32 valuesCount)
         {
-            delete[] mUpdateMask;
+            MANGOS_ASSERT(valuesCount <= MAX_FIELDS);
 
             mCount = valuesCount;
             mBlocks = (valuesCount + 31) / 32;
 
-            mUpdateMask = new uint32[mBlocks];
             memset(mUpdateMask, 0, mBlocks << 2);
         }
 
         void Clear()
         {
-            if (mUpdateMask)
-                memset(mUpdateMask, 0, mBlocks << 2);
+            memset(mUpdateMask, 0, mBlocks << 2);
         }
 
         UpdateMask& operator = (const UpdateMask& mask)
         {
-            SetCount(mask.mCount);
+            mCount = mask.mCount;
+            mBlocks = mask.mBlocks;
             memcpy(mUpdateMask, mask.mUpdateMask, mBlocks << 2);
 
             return *this;
@@ -88,7 +129,7 @@ class UpdateMask
         void operator |= (const UpdateMask& mask)
         {
             MANGOS_ASSERT(mask.mCount <= mCount);
-            for (uint32 i = 0; i < mBlocks; ++i)
+            for (uint32 i = 0; i < mask.mBlocks; ++i)
                 mUpdateMask[i] |= mask.mUpdateMask[i];
         }
 
@@ -115,8 +156,28 @@ class UpdateMask
         }
 
     private:
+        // value must not be 0
+        static uint32 CountTrailingZeros(uint32 value)
+        {
+#if COMPILER == COMPILER_MICROSOFT
+            unsigned long index;
+            _BitScanForward(&index, value);
+            return index;
+#elif COMPILER == COMPILER_GNU
+            return __builtin_ctz(value);
+#else
+            uint32 index = 0;
+            while (!(value & 1))
+            {
+                value >>= 1;
+                ++index;
+            }
+            return index;
+#endif
+        }
+
         uint32 mCount;
         uint32 mBlocks;
-        uint32* mUpdateMask;
+        uint32 mUpdateMask[MAX_BLOCKS];
 };
 #endif
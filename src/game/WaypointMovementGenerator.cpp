@@ -26,6 +26,7 @@
 #include "WaypointManager.h"
 #include "WorldPacket.h"
 #include "ScriptMgr.h"
+#include "World.h"
 #include "movement/MoveSplineInit.h"
 #include "movement/MoveSpline.h"
 
@@ -358,6 +359,8 @@ void FlightPathMovementGenerator::Reset(Player& player)
     init.SetFly();
     init.SetVelocity(PLAYER_FLIGHT_SPEED);
     init.Launch();
+
+    PreloadPathAhead(player);
 }
 
 bool FlightPathMovementGenerator::Update(Player& player, const uint32& diff)
@@ -375,11 +378,35 @@ bool FlightPathMovementGenerator::Update(Player& player, const uint32& diff)
             departureEvent = !departureEvent;
         }
         while (true);
+
+        PreloadPathAhead(player);
     }
 
     return i_currentNode < (i_path->size() - 1);
 }
 
+void FlightPathMovementGenerator::PreloadPathAhead(Player& player) const
+{
+    uint32 distance = sWorld.getConfig(CONFIG_UINT32_GRID_PRELOAD_DISTANCE);
+    if (!distance)
+        return;
+
+    float x = player.GetPositionX();
+    float y = player.GetPositionY();
+    float pathLength = 0.0f;
+
+    uint32 end = GetPathAtMapEnd();
+    for (uint32 i = i_currentNode; i < end && pathLength < distance; ++i)
+    {
+        TaxiPathNodeEntry const& node = (*i_path)[i];
+        pathLength += sqrt((node.x - x) * (node.x - x) + (node.y - y) * (node.y - y));
+        x = node.x;
+        y = node.y;
+
+        player.GetMap()->PreloadTerrain(x, y);
+    }
+}
+
 void FlightPathMovementGenerator::SetCurrentNodeAfterTeleport()
 {
     if (i_path->empty())
@@ -128,6 +128,10 @@ class MANGOS_DLL_SPEC FlightPathMovementGenerator
         void SkipCurrentNode() { ++i_currentNode; }
         void DoEventIfAny(Player& player, TaxiPathNodeEntry const& node, bool departure);
         bool GetResetPosition(Player&, float& x, float& y, float& z) const;
+
+    private:
+        // queue terrain of the grids along the next part of the flight for background loading
+        void PreloadPathAhead(Player& player) const;
 };
 
 #endif
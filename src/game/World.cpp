@@ -67,6 +67,7 @@
 #include "CharacterDatabaseCleaner.h"
 #include "CreatureLinkingMgr.h"
 #include "Calendar.h"
+#include "StartupTaskGraph.h"
 
 INSTANTIATE_SINGLETON_1(World);
 
@@ -549,6 +550,21 @@ void World::LoadConfigSettings(bool reload)
     if (reload)
         sMapMgr.SetMapUpdateInterval(getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
 
+    if (configNoReload(reload, CONFIG_UINT32_MAPUPDATE_THREADS, "MapUpdate.Threads", 0))
+        setConfig(CONFIG_UINT32_MAPUPDATE_THREADS, "MapUpdate.Threads", 0);
+
+    setConfig(CONFIG_UINT32_MAPUPDATE_SLOW_LOG_TIME, "MapUpdate.SlowLogTime", 0);
+    setConfig(CONFIG_UINT32_WORLDUPDATE_SLOW_LOG_TIME, "WorldUpdate.SlowLogTime", 0);
+
+    if (configNoReload(reload, CONFIG_UINT32_GRID_PRELOAD_DISTANCE, "GridPreload.Distance", 0))
+        setConfig(CONFIG_UINT32_GRID_PRELOAD_DISTANCE, "GridPreload.Distance", 0);
+
+    if (configNoReload(reload, CONFIG_UINT32_MMAP_PATH_THREADS, "mmap.pathThreads", 0))
+        setConfig(CONFIG_UINT32_MMAP_PATH_THREADS, "mmap.pathThreads", 0);
+
+    if (configNoReload(reload, CONFIG_UINT32_STARTUP_LOADING_THREADS, "StartupLoading.Threads", 0))
+        setConfig(CONFIG_UINT32_STARTUP_LOADING_THREADS, "StartupLoading.Threads", 0);
+
     setConfig(CONFIG_UINT32_INTERVAL_CHANGEWEATHER, "ChangeWeatherInterval", 10 * MINUTE * IN_MILLISECONDS);
 
     if (configNoReload(reload, CONFIG_UINT32_PORT_WORLD, "WorldServerPort", DEFAULT_WORLDSERVER_PORT))
@@ -1009,89 +1025,48 @@ void World::SetInitialWorldSettings()
     sObjectMgr.SetHighestGuids();                           // must be after PackInstances() and PackGroupIds()
     sLog.outString();
 
-    sLog.outString("Loading Page Texts...");
-    sObjectMgr.LoadPageTexts();
-
-    sLog.outString("Loading Game Object Templates...");     // must be after LoadPageTexts
-    sObjectMgr.LoadGameobjectInfo();
-
-    sLog.outString("Loading GameObject models...");
-    LoadGameObjectModelList();
-
-    sLog.outString("Loading Spell Chain Data...");
-    sSpellMgr.LoadSpellChains();
-
-    sLog.outString("Loading Spell Elixir types...");
-    sSpellMgr.LoadSpellElixirs();
-
-    sLog.outString("Loading Spell Learn Skills...");
-    sSpellMgr.LoadSpellLearnSkills();                       // must be after LoadSpellChains
-
-    sLog.outString("Loading Spell Learn Spells...");
-    sSpellMgr.LoadSpellLearnSpells();
-
-    sLog.outString("Loading Spell Proc Event conditions...");
-    sSpellMgr.LoadSpellProcEvents();
-
-    sLog.outString("Loading Spell Bonus Data...");
-    sSpellMgr.LoadSpellBonuses();                           // must be after LoadSpellChains
-
-    sLog.outString("Loading Spell Proc Item Enchant...");
-    sSpellMgr.LoadSpellProcItemEnchant();                   // must be after LoadSpellChains
-
-    sLog.outString("Loading Aggro Spells Definitions...");
-    sSpellMgr.LoadSpellThreats();
-
-    sLog.outString("Loading NPC Texts...");
-    sObjectMgr.LoadGossipText();
-
-    sLog.outString("Loading Item Random Enchantments Table...");
-    LoadRandomEnchantmentsTable();
-
-    sLog.outString("Loading Items...");                     // must be after LoadRandomEnchantmentsTable and LoadPageTexts
-    sObjectMgr.LoadItemPrototypes();
-
-    sLog.outString("Loading Item converts...");             // must be after LoadItemPrototypes
-    sObjectMgr.LoadItemConverts();
-
-    sLog.outString("Loading Item expire converts...");      // must be after LoadItemPrototypes
-    sObjectMgr.LoadItemExpireConverts();
-
-    sLog.outString("Loading Creature Model Based Info Data...");
-    sObjectMgr.LoadCreatureModelInfo();
-
-    sLog.outString("Loading Equipment templates...");
-    sObjectMgr.LoadEquipmentTemplates();
-
-    sLog.outString("Loading Creature templates...");
-    sObjectMgr.LoadCreatureTemplates();
-
-    sLog.outString("Loading Creature template spells...");
-    sObjectMgr.LoadCreatureTemplateSpells();
-
-    sLog.outString("Loading Creature Model for race...");   // must be after creature templates
-    sObjectMgr.LoadCreatureModelRace();
+    ///- Load templates, independent loaders run in parallel if enabled
+    {
+        typedef StartupTaskGraph::TaskId TaskId;
+        StartupTaskGraph stage("Templates");
 
-    sLog.outString("Loading SpellsScriptTarget...");
-    sSpellMgr.LoadSpellScriptTarget();                      // must be after LoadCreatureTemplates and LoadGameobjectInfo
+        TaskId pageTexts = stage.AddTask("Page Texts", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadPageTexts));
+        TaskId goInfo = stage.AddTask("Game Object Templates", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadGameobjectInfo), pageTexts);
+        stage.AddTask("GameObject models", &LoadGameObjectModelList);
 
-    sLog.outString("Loading Vehicle Accessory...");         // must be after creature templates
-    sObjectMgr.LoadVehicleAccessory();
+        // SpellMgr loaders use the spell chains, keep them in sequence
+        TaskId spellMgrTask = stage.AddTask("Spell Chain Data", new MaNGOS::Callback<SpellMgr>(&sSpellMgr, &SpellMgr::LoadSpellChains));
+        spellMgrTask = stage.AddTask("Spell Elixir types", new MaNGOS::Callback<SpellMgr>(&sSpellMgr, &SpellMgr::LoadSpellElixirs), spellMgrTask);
+        spellMgrTask = stage.AddTask("Spell Learn Skills", new MaNGOS::Callback<SpellMgr>(&sSpellMgr, &SpellMgr::LoadSpellLearnSkills), spellMgrTask);
+        spellMgrTask = stage.AddTask("Spell Learn Spells", new MaNGOS::Callback<SpellMgr>(&sSpellMgr, &SpellMgr::LoadSpellLearnSpells), spellMgrTask);
+        spellMgrTask = stage.AddTask("Spell Proc Event conditions", new MaNGOS::Callback<SpellMgr>(&sSpellMgr, &SpellMgr::LoadSpellProcEvents), spellMgrTask);
+        spellMgrTask = stage.AddTask("Spell Bonus Data", new MaNGOS::Callback<SpellMgr>(&sSpellMgr, &SpellMgr::LoadSpellBonuses), spellMgrTask);
+        spellMgrTask = stage.AddTask("Spell Proc Item Enchant", new MaNGOS::Callback<SpellMgr>(&sSpellMgr, &SpellMgr::LoadSpellProcItemEnchant), spellMgrTask);
+        spellMgrTask = stage.AddTask("Aggro Spells Definitions", new MaNGOS::Callback<SpellMgr>(&sSpellMgr, &SpellMgr::LoadSpellThreats), spellMgrTask);
 
-    sLog.outString("Loading ItemRequiredTarget...");
-    sObjectMgr.LoadItemRequiredTarget();
+        stage.AddTask("NPC Texts", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadGossipText));
 
-    sLog.outString("Loading Reputation Reward Rates...");
-    sObjectMgr.LoadReputationRewardRate();
+        TaskId randomEnchants = stage.AddTask("Item Random Enchantments Table", &LoadRandomEnchantmentsTable);
+        TaskId items = stage.AddTask("Items", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadItemPrototypes), randomEnchants, pageTexts);
+        stage.AddTask("Item converts", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadItemConverts), items);
+        stage.AddTask("Item expire converts", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadItemExpireConverts), items);
 
-    sLog.outString("Loading Creature Reputation OnKill Data...");
-    sObjectMgr.LoadReputationOnKill();
+        TaskId modelInfo = stage.AddTask("Creature Model Based Info Data", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadCreatureModelInfo));
+        TaskId equipment = stage.AddTask("Equipment templates", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadEquipmentTemplates));
+        TaskId creatures = stage.AddTask("Creature templates", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadCreatureTemplates), modelInfo, equipment);
+        stage.AddTask("Creature template spells", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadCreatureTemplateSpells), creatures);
+        stage.AddTask("Creature Model for race", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadCreatureModelRace), creatures);
+        stage.AddTask("SpellsScriptTarget", new MaNGOS::Callback<SpellMgr>(&sSpellMgr, &SpellMgr::LoadSpellScriptTarget), creatures, goInfo, spellMgrTask);
+        stage.AddTask("Vehicle Accessory", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadVehicleAccessory), creatures);
+        stage.AddTask("ItemRequiredTarget", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadItemRequiredTarget), items, creatures);
 
-    sLog.outString("Loading Reputation Spillover Data...");
-    sObjectMgr.LoadReputationSpilloverTemplate();
+        stage.AddTask("Reputation Reward Rates", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadReputationRewardRate));
+        stage.AddTask("Creature Reputation OnKill Data", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadReputationOnKill), creatures);
+        stage.AddTask("Reputation Spillover Data", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadReputationSpilloverTemplate));
+        stage.AddTask("Points Of Interest Data", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadPointsOfInterest));
 
-    sLog.outString("Loading Points Of Interest Data...");
-    sObjectMgr.LoadPointsOfInterest();
+        stage.Run(getConfig(CONFIG_UINT32_STARTUP_LOADING_THREADS));
+    }
 
     sLog.outString("Loading Creature Data...");
     sObjectMgr.LoadCreatures();
@@ -1175,41 +1150,33 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading event id script names...");
     sScriptMgr.LoadEventIdScripts();
 
-    sLog.outString("Loading Graveyard-zone links...");
-    sObjectMgr.LoadGraveyardZones();
-
-    sLog.outString("Loading spell target destination coordinates...");
-    sSpellMgr.LoadSpellTargetPositions();
-
-    sLog.outString("Loading spell pet auras...");
-    sSpellMgr.LoadSpellPetAuras();
-
-    sLog.outString("Loading Player Create Info & Level Stats...");
-    sLog.outString();
-    sObjectMgr.LoadPlayerInfo();
-    sLog.outString(">>> Player Create Info & Level Stats loaded");
-    sLog.outString();
+    ///- Load player and pet data, independent loaders run in parallel if enabled
+    {
+        StartupTaskGraph stage("Player and pet data");
 
-    sLog.outString("Loading Exploration BaseXP Data...");
-    sObjectMgr.LoadExplorationBaseXP();
+        stage.AddTask("Graveyard-zone links", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadGraveyardZones));
+        stage.AddTask("spell target destination coordinates", new MaNGOS::Callback<SpellMgr>(&sSpellMgr, &SpellMgr::LoadSpellTargetPositions));
+        stage.AddTask("spell pet auras", new MaNGOS::Callback<SpellMgr>(&sSpellMgr, &SpellMgr::LoadSpellPetAuras));
+        stage.AddTask("Player Create Info & Level Stats", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadPlayerInfo));
+        stage.AddTask("Exploration BaseXP Data", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadExplorationBaseXP));
+        stage.AddTask("Pet Name Parts", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadPetNames));
+        stage.AddTask("pet level stats", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadPetLevelInfo));
+        stage.AddTask("Player level dependent mail rewards", new MaNGOS::Callback<ObjectMgr>(&sObjectMgr, &ObjectMgr::LoadMailLevelRewards));
 
-    sLog.outString("Loading Pet Name Parts...");
-    sObjectMgr.LoadPetNames();
+        stage.Run(getConfig(CONFIG_UINT32_STARTUP_LOADING_THREADS));
+    }
 
     CharacterDatabaseCleaner::CleanDatabase();
 
+    sLog.outString("Loading character names...");
+    sObjectMgr.LoadCharacterNames();
+
     sLog.outString("Loading the max pet number...");
     sObjectMgr.LoadPetNumber();
 
-    sLog.outString("Loading pet level stats...");
-    sObjectMgr.LoadPetLevelInfo();
-
     sLog.outString("Loading Player Corpses...");
     sObjectMgr.LoadCorpses();
 
-    sLog.outString("Loading Player level dependent mail rewards...");
-    sObjectMgr.LoadMailLevelRewards();
-
     sLog.outString("Loading Loot Tables...");
     sLog.outString();
     LoadLootTables();
@@ -1435,6 +1402,8 @@ void World::SetInitialWorldSettings()
     sLog.outString("Initialize AuctionHouseBot...");
     sAuctionBot.Initialize();
 
+    StartupTaskGraph::PrintReport();
+
     sLog.outString("WORLD: World initialized");
 
     uint32 uStartInterval = WorldTimer::getMSTimeDiff(uStartTime, WorldTimer::getMSTime());
@@ -1490,6 +1459,8 @@ void World::DetectDBCLang()
 /// Update the World !
 void World::Update(uint32 diff)
 {
+    m_tickProfiler.StartTick();
+
     ///- Update the different timers
     for (int i = 0; i < WUPDATE_COUNT; ++i)
     {
@@ -1541,8 +1512,11 @@ void World::Update(uint32 diff)
         m_timers[WUPDATE_AHBOT].Reset();
     }
 
+    m_tickProfiler.EndPhase(TICK_PHASE_TIMERS);
+
     /// <li> Handle session updates
     UpdateSessions(diff);
+    m_tickProfiler.EndPhase(TICK_PHASE_SESSIONS);
 
     /// <li> Handle weather updates when the timer has passed
     if (m_timers[WUPDATE_WEATHERS].Passed())
@@ -1571,13 +1545,62 @@ void World::Update(uint32 diff)
 
         m_timers[WUPDATE_UPTIME].Reset();
         LoginDatabase.PExecute("UPDATE uptime SET uptime = %u, maxplayers = %u WHERE realmid = %u AND starttime = " UI64FMTD, tmpDiff, maxClientsNum, realmID, uint64(m_startTime));
+
+        PlayerSaveStats saveStats = Player::GetSaveStats(true);
+        if (saveStats.saves)
+            sLog.outString("Character saves: %u, average %u statements and %u bytes per save",
+                           saveStats.saves, uint32(saveStats.statements / saveStats.saves), uint32(saveStats.bytes / saveStats.saves));
+
+        GridPreloadStats gridStats = sTerrainMgr.GetPreloader().GetStats(true);
+        if (gridStats.blockedLoads || gridStats.requests)
+            sLog.outString("Grid terrain loads: %u blocked a map update (%u ms total), %u used preloaded data, %u grids requested for preloading, %u expired unused",
+                           gridStats.blockedLoads, gridStats.blockedTime, gridStats.used, gridStats.requests, gridStats.expired);
+
+        MMAP::NavMeshQueryStats queryStats = MMAP::MMapFactory::createOrGetMMapManager()->GetQueryStats(true);
+        if (queryStats.pathSearches)
+            sLog.outString("Path searches: %u, %u ran out of search nodes, %u navmesh queries allocated, %u reused for another map",
+                           queryStats.pathSearches, queryStats.nodeExhaustions, queryStats.queriesCreated, queryStats.queriesEvicted);
+
+        PathRequestStats pathStats = sMapMgr.GetPathRequests().GetStats(true);
+        if (pathStats.requests)
+            sLog.outString("Path requests: %u, %u coalesced, %u calculated in %u ms, %u reused a cached corridor",
+                           pathStats.requests, pathStats.coalesced, pathStats.built, pathStats.buildTime, pathStats.corridorHits);
+
+        UnitProcStats procStats = Unit::GetProcStats(true);
+        if (procStats.procs)
+        {
+            uint32 seconds = std::max(m_timers[WUPDATE_UPTIME].GetInterval() / IN_MILLISECONDS, time_t(1));
+            sLog.outString("Proc handling: %u procs and %u aura checks per second, %u of %u auras checked per proc",
+                           uint32(procStats.procs / seconds), uint32(procStats.checks / seconds),
+                           procStats.checks / procStats.procs, procStats.holders / procStats.procs);
+        }
+
+        Database* databases[] = { &LoginDatabase, &WorldDatabase, &CharacterDatabase };
+        char const* databaseNames[] = { "login", "world", "character" };
+        for (int i = 0; i < 3; ++i)
+        {
+            SqlDelayQueueStats sqlStats = databases[i]->GetAsyncQueueStats(true);
+            if (sqlStats.executed || sqlStats.queued)
+                sLog.outString("Async %s database requests: " UI64FMTD " executed, %u queued (max %u), latency avg %u ms max %u ms",
+                               databaseNames[i], sqlStats.executed, sqlStats.queued, sqlStats.maxQueued, sqlStats.avgLatency, sqlStats.maxLatency);
+        }
+
+        m_tickProfiler.LogReport();
     }
 
+    m_tickProfiler.EndPhase(TICK_PHASE_WEATHERS);
+
     /// <li> Handle all other objects
     ///- Update objects (maps, transport, creatures,...)
     sMapMgr.Update(diff);
+    m_tickProfiler.EndPhase(TICK_PHASE_MAPS);
+    if (sMapMgr.AreMapsUpdated())
+        m_tickProfiler.AddMapTimes(sMapMgr);
+
     sBattleGroundMgr.Update(diff);
+    m_tickProfiler.EndPhase(TICK_PHASE_BATTLEGROUNDS);
     sOutdoorPvPMgr.Update(diff);
+    m_tickProfiler.EndPhase(TICK_PHASE_OUTDOORPVP);
 
     ///- Delete all characters which have been deleted X days before
     if (m_timers[WUPDATE_DELETECHARS].Passed())
@@ -1588,6 +1611,7 @@ void World::Update(uint32 diff)
 
     // execute callbacks from sql queries that were queued recently
     UpdateResultQueue();
+    m_tickProfiler.EndPhase(TICK_PHASE_RESULT_QUEUE);
 
     ///- Erase corpses once every 20 minutes
     if (m_timers[WUPDATE_CORPSES].Passed())
@@ -1606,18 +1630,28 @@ void World::Update(uint32 diff)
         m_timers[WUPDATE_EVENTS].Reset();
     }
 
+    m_tickProfiler.EndPhase(TICK_PHASE_GAME_EVENTS);
+
     /// </ul>
     ///- Move all creatures with "delayed move" and remove and delete all objects with "delayed remove"
     sMapMgr.RemoveAllObjectsInRemoveList();
+    m_tickProfiler.EndPhase(TICK_PHASE_REMOVE_LIST);
 
     // update the instance reset times
     sMapPersistentStateMgr.Update();
 
     // And last, but not least handle the issued cli commands
     ProcessCliCommands();
+    m_tickProfiler.EndPhase(TICK_PHASE_CLI);
 
     // cleanup unused GridMap objects as well as VMaps
     sTerrainMgr.Update(diff);
+    m_tickProfiler.EndPhase(TICK_PHASE_TERRAIN);
+
+    uint32 tickTime = m_tickProfiler.EndTick();
+    if (uint32 budget = getConfig(CONFIG_UINT32_WORLDUPDATE_SLOW_LOG_TIME))
+        if (tickTime >= budget * 1000)
+            m_tickProfiler.LogLastTick(budget);
 }
 
 namespace MaNGOS
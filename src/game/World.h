@@ -27,6 +27,7 @@
 #include "Timer.h"
 #include "Policies/Singleton.h"
 #include "SharedDefines.h"
+#include "WorldTickProfiler.h"
 
 #include <map>
 #include <set>
@@ -88,6 +89,12 @@ enum eConfigUInt32Values
     CONFIG_UINT32_INTERVAL_SAVE,
     CONFIG_UINT32_INTERVAL_GRIDCLEAN,
     CONFIG_UINT32_INTERVAL_MAPUPDATE,
+    CONFIG_UINT32_MAPUPDATE_THREADS,
+    CONFIG_UINT32_MAPUPDATE_SLOW_LOG_TIME,
+    CONFIG_UINT32_WORLDUPDATE_SLOW_LOG_TIME,
+    CONFIG_UINT32_GRID_PRELOAD_DISTANCE,
+    CONFIG_UINT32_MMAP_PATH_THREADS,
+    CONFIG_UINT32_STARTUP_LOADING_THREADS,
     CONFIG_UINT32_INTERVAL_CHANGEWEATHER,
     CONFIG_UINT32_PORT_WORLD,
     CONFIG_UINT32_GAME_TYPE,
@@ -629,6 +636,7 @@ class World
         time_t m_startTime;
         time_t m_gameTime;
         IntervalTimer m_timers[WUPDATE_COUNT];
+        WorldTickProfiler m_tickProfiler;
         uint32 mail_timer;
         uint32 mail_timer_expires;
 
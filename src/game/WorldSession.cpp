@@ -36,6 +36,7 @@
 #include "BattleGround/BattleGroundMgr.h"
 #include "MapManager.h"
 #include "SocialMgr.h"
+#include "OpcodeProfiler.h"
 #include "Auth/AuthCrypt.h"
 #include "Auth/HMACSHA1.h"
 #include "zlib/zlib.h"
@@ -110,7 +111,7 @@ WorldSession::~WorldSession()
     }
 
     ///- empty incoming packet queue
-    WorldPacket* packet = NULL;
+    ReceivedPacket* packet = NULL;
     while (_recvQueue.next(packet))
         delete packet;
 }
@@ -174,11 +175,56 @@ void WorldSession::SendPacket(WorldPacket const* packet)
 }
 
 /// Add an incoming packet to the queue
-void WorldSession::QueuePacket(WorldPacket* new_packet)
+void WorldSession::QueuePacket(ReceivedPacket* new_packet)
 {
+    new_packet->receiveTime = WorldTimer::getMSTime();
+    ++m_recvQueueSize;
     _recvQueue.add(new_packet);
 }
 
+/// Account a packet taken from the queue
+void WorldSession::CountReceivedPacket(ReceivedPacket const& packet)
+{
+    uint32 queueSize = uint32(m_recvQueueSize.value());     // including this packet
+    --m_recvQueueSize;
+
+    uint32 waitTime = WorldTimer::getMSTimeDiff(packet.receiveTime, WorldTimer::getMSTime());
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_packetStatsLock);
+
+    ++m_packetStats.processed;
+    m_packetStats.totalWaitTime += waitTime;
+    if (queueSize > m_packetStats.peakQueueSize)
+        m_packetStats.peakQueueSize = queueSize;
+    if (waitTime > m_packetStats.maxWaitTime)
+    {
+        m_packetStats.maxWaitTime = waitTime;
+        m_packetStats.maxWaitOpcode = packet.GetOpcode();
+    }
+
+    OpcodeWaitStats& opcodeStats = m_packetStats.opcodes[packet.GetOpcode()];
+    ++opcodeStats.processed;
+    opcodeStats.totalWaitTime += waitTime;
+    if (waitTime > opcodeStats.maxWaitTime)
+        opcodeStats.maxWaitTime = waitTime;
+}
+
+SessionPacketStats WorldSession::GetPacketStats() const
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_packetStatsLock, SessionPacketStats());
+
+    return m_packetStats;
+}
+
+/// Hand a handled packet back to the socket, it receives the next packets into it
+void WorldSession::RecyclePacket(ReceivedPacket* packet)
+{
+    if (m_Socket)
+        m_Socket->RecyclePacket(packet);
+    else
+        delete packet;
+}
+
 /// Logging helper for unexpected opcodes
 void WorldSession::LogUnexpectedOpcode(WorldPacket* packet, const char* reason)
 {
@@ -202,9 +248,11 @@ bool WorldSession::Update(PacketFilter& updater)
 {
     ///- Retrieve packets from the receive queue and call the appropriate handlers
     /// not process packets if socket already closed
-    WorldPacket* packet = NULL;
+    ReceivedPacket* packet = NULL;
     while (m_Socket && !m_Socket->IsClosed() && _recvQueue.next(packet, updater))
     {
+        CountReceivedPacket(*packet);
+
         /*#if 1
         sLog.outError( "MOEP: %s (0x%.4X)",
                         packet->GetOpcodeName(),
@@ -296,7 +344,7 @@ bool WorldSession::Update(PacketFilter& updater)
             }
         }
 
-        delete packet;
+        RecyclePacket(packet);
     }
 
     ///- Cleanup socket pointer if need
@@ -967,6 +1015,9 @@ void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* pac
     if (_player)
         _player->SetCanDelayTeleport(true);
 
+    bool profile = sOpcodeProfiler.IsActive();
+    ACE_Time_Value startTime = profile ? ACE_OS::gettimeofday() : ACE_Time_Value::zero;
+
     (this->*opHandle.handler)(*packet);
 
     if (_player)
@@ -980,6 +1031,13 @@ void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* pac
             _player->TeleportTo(_player->m_teleport_dest, _player->m_teleport_options);
     }
 
+    if (profile)
+    {
+        ACE_UINT64 time;
+        (ACE_OS::gettimeofday() - startTime).to_usec(time);
+        sOpcodeProfiler.AddSample(packet->GetOpcode(), uint32(time), packet->size());
+    }
+
     if (packet->rpos() < packet->wpos() && sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG))
         LogUnprocessedTail(packet);
 }
@@ -28,6 +28,9 @@
 #include "ObjectGuid.h"
 #include "AuctionHouseMgr.h"
 #include "Item.h"
+#include "MPSCQueue.h"
+
+#include <ace/Atomic_Op.h>
 
 struct ItemPrototype;
 struct AuctionEntry;
@@ -42,6 +45,7 @@ class Player;
 class Unit;
 class WorldPacket;
 class WorldSocket;
+class ReceivedPacket;
 class QueryResult;
 class LoginQueryHolder;
 class CharacterHandler;
@@ -51,6 +55,29 @@ class WorldSession;
 
 struct OpcodeHandler;
 
+struct OpcodeWaitStats
+{
+    OpcodeWaitStats() : processed(0), totalWaitTime(0), maxWaitTime(0) {}
+
+    uint32 processed;
+    uint64 totalWaitTime;                                   ///< time the packets of the opcode spent in the queue
+    uint32 maxWaitTime;
+};
+
+typedef std::map<uint16, OpcodeWaitStats> OpcodeWaitStatsMap;
+
+struct SessionPacketStats
+{
+    SessionPacketStats() : processed(0), peakQueueSize(0), totalWaitTime(0), maxWaitTime(0), maxWaitOpcode(0) {}
+
+    uint32 processed;                                       ///< packets taken from the receive queue
+    uint32 peakQueueSize;                                   ///< most packets waiting at the same time
+    uint64 totalWaitTime;                                   ///< time the packets spent in the queue
+    uint32 maxWaitTime;
+    uint16 maxWaitOpcode;                                   ///< opcode of the packet that waited longest
+    OpcodeWaitStatsMap opcodes;                             ///< wait times of each received opcode
+};
+
 enum AccountDataType
 {
     GLOBAL_CONFIG_CACHE             = 0,                    // 0x01 g
@@ -286,7 +313,8 @@ class MANGOS_DLL_SPEC WorldSession
         void LogoutPlayer(bool Save);
         void KickPlayer();
 
-        void QueuePacket(WorldPacket* new_packet);
+        // called by the socket of the session only
+        void QueuePacket(ReceivedPacket* new_packet);
 
         bool Update(PacketFilter& updater);
 
@@ -294,8 +322,7 @@ class MANGOS_DLL_SPEC WorldSession
         void SendAuthWaitQue(uint32 position);
 
         void SendNameQueryOpcode(Player* p);
-        void SendNameQueryOpcodeFromDB(ObjectGuid guid);
-        static void SendNameQueryOpcodeFromDBCallBack(QueryResult* result, uint32 accountId);
+        void SendNameQueryOpcodeFromCache(ObjectGuid guid);
 
         void SendTrainerList(ObjectGuid guid);
         void SendTrainerList(ObjectGuid guid, const std::string& strTitle);
@@ -398,6 +425,9 @@ class MANGOS_DLL_SPEC WorldSession
 
         uint32 GetLatency() const { return m_latency; }
         void SetLatency(uint32 latency) { m_latency = latency; }
+
+        // copy of the statistics, they are updated by the thread handling the session
+        SessionPacketStats GetPacketStats() const;
         uint32 getDialogStatus(Player* pPlayer, Object* questgiver, uint32 defstatus);
 
         // Misc
@@ -887,6 +917,9 @@ class MANGOS_DLL_SPEC WorldSession
         void LogUnexpectedOpcode(WorldPacket* packet, const char* reason);
         void LogUnprocessedTail(WorldPacket* packet);
 
+        void CountReceivedPacket(ReceivedPacket const& packet);
+        void RecyclePacket(ReceivedPacket* packet);
+
         uint32 m_GUIDLow;                                   // set logged or recently logout player (while m_playerRecentlyLogout set)
         Player* _player;
         WorldSocket* m_Socket;
@@ -909,7 +942,10 @@ class MANGOS_DLL_SPEC WorldSession
         uint32 m_Tutorials[8];
         TutorialDataState m_tutorialState;
         AddonsList m_addonsList;
-        ACE_Based::LockedQueue<WorldPacket*, ACE_Thread_Mutex> _recvQueue;
+        ACE_Based::MPSCQueue<ReceivedPacket> _recvQueue;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_recvQueueSize;
+        SessionPacketStats m_packetStats;
+        mutable ACE_Thread_Mutex m_packetStatsLock;
 };
 #endif
 /// @}
@@ -96,6 +96,25 @@ struct ClientPktHeader
 #pragma pack(pop)
 #endif
 
+// handled packets kept per socket for receiving the next ones
+#define RECEIVED_PACKET_POOL_SIZE       16
+// packets with bigger buffers are rare, they are not kept
+#define RECEIVED_PACKET_POOL_MAX_BUFFER 1024
+
+/// Recycles a received packet when leaving the scope, unless it was released.
+class ReceivedPacketGuard
+{
+    public:
+        ReceivedPacketGuard(WorldSocket& socket, ReceivedPacket* pct) : m_socket(socket), m_pct(pct) {}
+        ~ReceivedPacketGuard() { if (m_pct) m_socket.RecyclePacket(m_pct); }
+
+        void release() { m_pct = NULL; }
+
+    private:
+        WorldSocket& m_socket;
+        ReceivedPacket* m_pct;
+};
+
 WorldSocket::WorldSocket(void) :
     WorldHandler(),
     m_LastPingTime(ACE_Time_Value::zero),
@@ -119,6 +138,10 @@ WorldSocket::~WorldSocket(void)
 {
     delete m_RecvWPct;
 
+    ReceivedPacket* pct;
+    while (m_PacketPool.next(pct))
+        delete pct;
+
     if (m_OutBuffer)
         m_OutBuffer->release();
 
@@ -488,7 +511,13 @@ int WorldSocket::handle_input_header(void)
 
     header.size -= 4;
 
-    ACE_NEW_RETURN(m_RecvWPct, WorldPacket(Opcodes(header.cmd), header.size), -1);
+    if (m_PacketPool.next(m_RecvWPct))
+    {
+        --m_PacketPoolSize;
+        m_RecvWPct->Initialize(Opcodes(header.cmd), header.size);
+    }
+    else
+        ACE_NEW_RETURN(m_RecvWPct, ReceivedPacket(Opcodes(header.cmd), header.size), -1);
 
     if (header.size > 0)
     {
@@ -654,12 +683,25 @@ int WorldSocket::schedule_wakeup_output(GuardType& g)
     return 0;
 }
 
-int WorldSocket::ProcessIncoming(WorldPacket* new_pct)
+void WorldSocket::RecyclePacket(ReceivedPacket* pct)
+{
+    // the size check may let a few more in when racing, no harm
+    if (pct->capacity() > RECEIVED_PACKET_POOL_MAX_BUFFER || m_PacketPoolSize.value() >= RECEIVED_PACKET_POOL_SIZE)
+    {
+        delete pct;
+        return;
+    }
+
+    ++m_PacketPoolSize;
+    m_PacketPool.add(pct);
+}
+
+int WorldSocket::ProcessIncoming(ReceivedPacket* new_pct)
 {
     MANGOS_ASSERT(new_pct);
 
     // manage memory ;)
-    ACE_Auto_Ptr<WorldPacket> aptr(new_pct);
+    ReceivedPacketGuard aptr(*this, new_pct);
 
     const ACE_UINT16 opcode = new_pct->GetOpcode();
 
@@ -35,6 +35,7 @@
 #include <ace/Guard_T.h>
 #include <ace/Unbounded_Queue.h>
 #include <ace/Message_Block.h>
+#include <ace/Atomic_Op.h>
 
 #if !defined (ACE_LACKS_PRAGMA_ONCE)
 #pragma once
@@ -43,11 +44,24 @@
 #include "Common.h"
 #include "Auth/AuthCrypt.h"
 #include "Auth/BigNumber.h"
+#include "WorldPacket.h"
+#include "MPSCQueue.h"
 
 class ACE_Message_Block;
-class WorldPacket;
 class WorldSession;
 
+/// Packet received from the client, reused by the socket for the next ones once its session handled it
+class ReceivedPacket : public WorldPacket, public ACE_Based::MPSCQueueNode
+{
+    public:
+        ReceivedPacket(Opcodes opcode, size_t size) : WorldPacket(opcode, size), receiveTime(0) {}
+
+        size_t capacity() const { return _storage.capacity(); }
+
+        /// Time when the packet was queued for the session
+        uint32 receiveTime;
+};
+
 /// Handler that can communicate over stream sockets.
 typedef ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH> WorldHandler;
 
@@ -125,6 +139,9 @@ class WorldSocket : protected WorldHandler
         /// Return the session key
         BigNumber& GetSessionKey() { return m_s; }
 
+        /// Give back a received packet handled by the session, this function is reentrant.
+        void RecyclePacket(ReceivedPacket* pct);
+
     protected:
         /// things called by ACE framework.
         WorldSocket(void);
@@ -164,8 +181,8 @@ class WorldSocket : protected WorldHandler
         int handle_output_queue(GuardType& g);
 
         /// process one incoming packet.
-        /// @param new_pct received packet ,note that you need to delete it.
-        int ProcessIncoming(WorldPacket* new_pct);
+        /// @param new_pct received packet, recycled unless it is queued for the session.
+        int ProcessIncoming(ReceivedPacket* new_pct);
 
         /// Called by ProcessIncoming() on CMSG_AUTH_SESSION.
         int HandleAuthSession(WorldPacket& recvPacket);
@@ -193,7 +210,11 @@ class WorldSocket : protected WorldHandler
         WorldSession* m_Session;
 
         /// here are stored the fragments of the received data
-        WorldPacket* m_RecvWPct;
+        ReceivedPacket* m_RecvWPct;
+
+        /// Packets handled by the session, reused for the next received ones.
+        ACE_Based::MPSCQueue<ReceivedPacket> m_PacketPool;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_PacketPoolSize;
 
         /// This block actually refers to m_RecvWPct contents,
         /// which allows easy and safe writing to it.
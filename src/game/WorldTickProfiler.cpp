@@ -0,0 +1,188 @@
+/**
+ * This code is part of MaNGOS. Contributor & Copyright details are in AUTHORS/THANKS.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "WorldTickProfiler.h"
+#include "MapManager.h"
+#include "Log.h"
+
+#include <algorithm>
+
+// slowest maps listed for a slow tick and in the report
+#define TICK_PROFILE_LISTED_MAPS    5
+
+static char const* const tickPhaseNames[MAX_TICK_PHASES] =
+{
+    "timers",
+    "sessions",
+    "weathers",
+    "maps",
+    "battlegrounds",
+    "outdoorpvp",
+    "results",
+    "events",
+    "removelist",
+    "cli",
+    "terrain"
+};
+
+static bool SortByTime(std::pair<uint32, uint32> const& left, std::pair<uint32, uint32> const& right)
+{
+    return left.first > right.first;
+}
+
+template<class T>
+static bool SortMapsByTime(T const& left, T const& right)
+{
+    return left.time > right.time;
+}
+
+WorldTickProfiler::WorldTickProfiler() : m_windowPos(0), m_windowSize(0)
+{
+    memset(m_phases, 0, sizeof(m_phases));
+    memset(m_window, 0, sizeof(m_window));
+}
+
+void WorldTickProfiler::StartTick()
+{
+    m_tickStart = ACE_OS::gettimeofday();
+    m_phaseStart = m_tickStart;
+    memset(m_phases, 0, sizeof(m_phases));
+    m_lastMaps.clear();
+}
+
+void WorldTickProfiler::EndPhase(WorldTickPhase phase)
+{
+    ACE_Time_Value now = ACE_OS::gettimeofday();
+
+    ACE_UINT64 time;
+    (now - m_phaseStart).to_usec(time);
+    m_phases[phase] += uint32(time);
+
+    m_phaseStart = now;
+}
+
+void WorldTickProfiler::AddMapTimes(MapManager const& mapMgr)
+{
+    for (MapManager::MapMapType::const_iterator itr = mapMgr.Maps().begin(); itr != mapMgr.Maps().end(); ++itr)
+    {
+        Map const* map = itr->second;
+
+        MapTickTime mapTime;
+        mapTime.mapId = map->GetId();
+        mapTime.instanceId = map->GetInstanceId();
+        mapTime.time = map->GetLastUpdateTime();
+        mapTime.updates = 1;
+        mapTime.players = map->GetPlayers().getSize();
+        m_lastMaps.push_back(mapTime);
+
+        MapTickTime& total = m_mapTotals[(uint64(mapTime.mapId) << 32) | mapTime.instanceId];
+        total.mapId = mapTime.mapId;
+        total.instanceId = mapTime.instanceId;
+        total.time += mapTime.time;
+        ++total.updates;
+        total.players = std::max(total.players, mapTime.players);
+    }
+}
+
+uint32 WorldTickProfiler::EndTick()
+{
+    ACE_UINT64 tickTime;
+    (ACE_OS::gettimeofday() - m_tickStart).to_usec(tickTime);
+
+    uint32* slot = m_window[m_windowPos];
+    memcpy(slot, m_phases, sizeof(m_phases));
+    slot[MAX_TICK_PHASES] = uint32(tickTime);
+
+    m_windowPos = (m_windowPos + 1) % TICK_PROFILE_WINDOW;
+    if (m_windowSize < TICK_PROFILE_WINDOW)
+        ++m_windowSize;
+
+    return uint32(tickTime);
+}
+
+void WorldTickProfiler::LogLastTick(uint32 budget) const
+{
+    std::vector<std::pair<uint32, uint32> > phases;
+    for (uint32 i = 0; i < MAX_TICK_PHASES; ++i)
+        phases.push_back(std::pair<uint32, uint32>(m_phases[i], i));
+
+    std::sort(phases.begin(), phases.end(), SortByTime);
+
+    std::ostringstream ss;
+    for (uint32 i = 0; i < phases.size(); ++i)
+        ss << " " << tickPhaseNames[phases[i].second] << " " << phases[i].first / 1000 << "." << (phases[i].first % 1000) / 100;
+
+    uint32 tickTime = m_window[(m_windowPos + TICK_PROFILE_WINDOW - 1) % TICK_PROFILE_WINDOW][MAX_TICK_PHASES];
+    sLog.outString("World update took %u ms (budget %u ms), phases in ms:%s", tickTime / 1000, budget, ss.str().c_str());
+
+    if (m_lastMaps.empty())
+        return;
+
+    MapTickTimeList maps = m_lastMaps;
+    std::sort(maps.begin(), maps.end(), SortMapsByTime<MapTickTime>);
+
+    for (uint32 i = 0; i < maps.size() && i < TICK_PROFILE_LISTED_MAPS && maps[i].time; ++i)
+        sLog.outString("    map %u instance %u with %u players: %u ms", maps[i].mapId, maps[i].instanceId, maps[i].players, maps[i].time);
+}
+
+void WorldTickProfiler::LogReport()
+{
+    if (!m_windowSize)
+        return;
+
+    std::vector<uint32> times(m_windowSize);
+
+    sLog.outString("World update times of the last %u ticks in ms (p50/p95/p99/max):", m_windowSize);
+
+    for (uint32 phase = 0; phase <= MAX_TICK_PHASES; ++phase)
+    {
+        for (uint32 i = 0; i < m_windowSize; ++i)
+            times[i] = m_window[i][phase];
+
+        std::sort(times.begin(), times.end());
+
+        uint32 p50 = times[m_windowSize * 50 / 100];
+        uint32 p95 = times[m_windowSize * 95 / 100];
+        uint32 p99 = times[m_windowSize * 99 / 100];
+        uint32 max = times.back();
+
+        // phases that never take a measurable time are left out
+        if (max < 1000 && phase != MAX_TICK_PHASES)
+            continue;
+
+        sLog.outString("    %-14s %u.%u / %u.%u / %u.%u / %u.%u", phase == MAX_TICK_PHASES ? "total" : tickPhaseNames[phase],
+                       p50 / 1000, (p50 % 1000) / 100, p95 / 1000, (p95 % 1000) / 100,
+                       p99 / 1000, (p99 % 1000) / 100, max / 1000, (max % 1000) / 100);
+    }
+
+    if (m_mapTotals.empty())
+        return;
+
+    MapTickTimeList maps;
+    for (MapTickTimeMap::const_iterator itr = m_mapTotals.begin(); itr != m_mapTotals.end(); ++itr)
+        maps.push_back(itr->second);
+
+    m_mapTotals.clear();
+
+    std::sort(maps.begin(), maps.end(), SortMapsByTime<MapTickTime>);
+
+    sLog.outString("Maps that took the most update time since the last report:");
+    for (uint32 i = 0; i < maps.size() && i < TICK_PROFILE_LISTED_MAPS && maps[i].time; ++i)
+        sLog.outString("    map %u instance %u with up to %u players: %u ms in %u updates", maps[i].mapId, maps[i].instanceId,
+                       maps[i].players, maps[i].time, maps[i].updates);
+}
@@ -0,0 +1,103 @@
+/**
+ * This code is part of MaNGOS. Contributor & Copyright details are in AUTHORS/THANKS.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_WORLDTICKPROFILER_H
+#define MANGOS_WORLDTICKPROFILER_H
+
+#include "Common.h"
+#include "ace/Time_Value.h"
+
+#include <vector>
+
+class MapManager;
+
+// parts of World::Update, in the order they are run
+enum WorldTickPhase
+{
+    TICK_PHASE_TIMERS               = 0,                    // game time, mass mails, quest resets, auctions and AH bot
+    TICK_PHASE_SESSIONS             = 1,
+    TICK_PHASE_WEATHERS             = 2,                    // weathers and uptime
+    TICK_PHASE_MAPS                 = 3,
+    TICK_PHASE_BATTLEGROUNDS        = 4,
+    TICK_PHASE_OUTDOORPVP           = 5,
+    TICK_PHASE_RESULT_QUEUE         = 6,                    // deleted characters and query callbacks
+    TICK_PHASE_GAME_EVENTS          = 7,                    // corpses and game events
+    TICK_PHASE_REMOVE_LIST          = 8,
+    TICK_PHASE_CLI                  = 9,                    // instance resets and cli commands
+    TICK_PHASE_TERRAIN              = 10,
+    MAX_TICK_PHASES                 = 11
+};
+
+// ticks the percentiles are calculated over
+#define TICK_PROFILE_WINDOW         1024
+
+/**
+ * Time spent in each phase of the last world ticks.
+ *
+ * The world thread marks the end of each phase, a tick costs one clock read per phase. The
+ * phase times of the last TICK_PROFILE_WINDOW ticks are kept for percentiles, the update time
+ * of each map is summed up until the next report.
+ */
+class WorldTickProfiler
+{
+    public:
+        WorldTickProfiler();
+
+        void StartTick();
+        void EndPhase(WorldTickPhase phase);
+
+        // called after the maps phase if the maps were updated
+        void AddMapTimes(MapManager const& mapMgr);
+
+        // returns the time of the tick in microseconds
+        uint32 EndTick();
+
+        // logs the phases of the last tick and its slowest maps
+        void LogLastTick(uint32 budget) const;
+
+        // logs the percentiles of the window and the maps that took the most time since the last report
+        void LogReport();
+
+    private:
+        struct MapTickTime
+        {
+            MapTickTime() : mapId(0), instanceId(0), time(0), updates(0), players(0) {}
+
+            uint32 mapId;
+            uint32 instanceId;
+            uint32 time;                                    ///< in milliseconds
+            uint32 updates;
+            uint32 players;
+        };
+
+        typedef std::vector<MapTickTime> MapTickTimeList;
+        typedef UNORDERED_MAP<uint64, MapTickTime> MapTickTimeMap;
+
+        ACE_Time_Value m_tickStart;
+        ACE_Time_Value m_phaseStart;
+
+        uint32 m_phases[MAX_TICK_PHASES];                   ///< phase times of the current tick in microseconds
+        uint32 m_window[TICK_PROFILE_WINDOW][MAX_TICK_PHASES + 1];  ///< phase and tick times of the last ticks
+        uint32 m_windowPos;
+        uint32 m_windowSize;
+
+        MapTickTimeList m_lastMaps;                         ///< maps updated in the current tick
+        MapTickTimeMap m_mapTotals;                         ///< map times since the last report
+};
+
+#endif
@@ -354,6 +354,82 @@ class BIH
             }
         }
 
+        // calls intersectCallback(entry) for every object of the nodes overlapping the box,
+        // one traversal collects the candidates for many queries inside the same area
+        template<typename BoxCallback>
+        void intersectBox(const AABox& box, BoxCallback& intersectCallback) const
+        {
+            if (!bounds.intersects(box))
+                return;
+
+            StackNode stack[MAX_STACK_SIZE];
+            int stackPos = 0;
+            int node = 0;
+
+            while (true)
+            {
+                while (true)
+                {
+                    uint32 tn = tree[node];
+                    uint32 axis = (tn & (3 << 30)) >> 30;
+                    bool BVH2 = tn & (1 << 29);
+                    int offset = tn & ~(7 << 29);
+                    if (!BVH2)
+                    {
+                        if (axis < 3)
+                        {
+                            // "normal" interior node
+                            float tl = intBitsToFloat(tree[node + 1]);
+                            float tr = intBitsToFloat(tree[node + 2]);
+                            bool left = box.low()[axis] <= tl;
+                            bool right = box.high()[axis] >= tr;
+                            // box is between clip zones
+                            if (!left && !right)
+                                break;
+                            node = left ? offset : offset + 3;
+                            // box overlaps both nodes, push back right node
+                            if (left && right)
+                            {
+                                stack[stackPos].node = offset + 3;
+                                ++stackPos;
+                            }
+                            continue;
+                        }
+                        else
+                        {
+                            // leaf - report all objects
+                            int n = tree[node + 1];
+                            while (n > 0)
+                            {
+                                intersectCallback(objects[offset]);
+                                --n;
+                                ++offset;
+                            }
+                            break;
+                        }
+                    }
+                    else // BVH2 node (empty space cut off left and right)
+                    {
+                        if (axis > 2)
+                            return; // should not happen
+                        float tl = intBitsToFloat(tree[node + 1]);
+                        float tr = intBitsToFloat(tree[node + 2]);
+                        node = offset;
+                        if (tl > box.high()[axis] || tr < box.low()[axis])
+                            break;
+                        continue;
+                    }
+                } // traversal loop
+
+                // stack is empty?
+                if (stackPos == 0)
+                    return;
+                // move back up the stack
+                --stackPos;
+                node = stack[stackPos].node;
+            }
+        }
+
         bool writeToFile(FILE* wf) const;
         bool readFromFile(FILE* rf);
 
@@ -40,6 +40,15 @@ namespace VMAP
 #define VMAP_INVALID_HEIGHT       -100000.0f            // for check
 #define VMAP_INVALID_HEIGHT_VALUE -200000.0f            // real assigned value in unknown height case
 
+    // one line of a batched line of sight check, in world coordinates
+    struct LineOfSightQuery
+    {
+        float srcX, srcY, srcZ;
+        float destX, destY, destZ;
+        uint32 phaseMask;                               // used for the gameobject models of DynamicMapTree only
+        bool result;                                    // set by the check, true if the line is free
+    };
+
     //===========================================================
     class IVMapManager
     {
@@ -60,6 +69,8 @@ namespace VMAP
             virtual void unloadMap(unsigned int pMapId) = 0;
 
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) = 0;
+            // checks count lines of the same map at once, they should be close to each other (like targets of an area spell)
+            virtual void isInLineOfSight(unsigned int pMapId, LineOfSightQuery* queries, uint32 count) = 0;
             virtual float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) = 0;
             /**
             test if we hit an object. return true if we hit one. rx,ry,rz will hold the hit position or the dest position, if no intersection was found
@@ -163,6 +163,63 @@ namespace VMAP
 
         return true;
     }
+    //=========================================================
+
+    class MapBoxCallback
+    {
+        public:
+            MapBoxCallback(std::vector<uint32>& entries) : iEntries(entries) {}
+            void operator()(uint32 entry) { iEntries.push_back(entry); }
+        protected:
+            std::vector<uint32>& iEntries;
+    };
+
+    void StaticMapTree::isInLineOfSight(const Vector3* pos1, const Vector3* pos2, uint32 count, bool* results) const
+    {
+        if (!count)
+            return;
+
+        // collect the models near any of the lines with one tree walk
+        G3D::AABox box(pos1[0].min(pos2[0]), pos1[0].max(pos2[0]));
+        for (uint32 i = 1; i < count; ++i)
+        {
+            box.merge(pos1[i]);
+            box.merge(pos2[i]);
+        }
+
+        std::vector<uint32> candidates;
+        MapBoxCallback boxCallback(candidates);
+        iTree.intersectBox(box, boxCallback);
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            results[i] = true;
+
+            float maxDist = (pos2[i] - pos1[i]).magnitude();
+            // valid map coords should *never ever* produce float overflow, but this would produce NaNs too:
+            MANGOS_ASSERT(maxDist < std::numeric_limits<float>::max());
+            if (maxDist < 1e-10f)
+                continue;
+
+            G3D::Ray ray = G3D::Ray::fromOriginAndDirection(pos1[i], (pos2[i] - pos1[i]) / maxDist);
+            for (std::vector<uint32>::const_iterator itr = candidates.begin(); itr != candidates.end(); ++itr)
+            {
+                ModelInstance const& model = iTreeValues[*itr];
+
+                // cheap bound test first, the tree walk did this only for the whole box
+                if (ray.intersectionTime(model.getBounds()) > maxDist)
+                    continue;
+
+                float distance = maxDist;
+                if (model.intersectRay(ray, distance, true))
+                {
+                    results[i] = false;
+                    break;
+                }
+            }
+        }
+    }
+
     //=========================================================
     /**
     When moving from pos1 to pos2 check if we hit an object. Return true and the position if we hit one
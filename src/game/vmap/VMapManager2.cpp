@@ -154,6 +154,35 @@ namespace VMAP
         }
         return result;
     }
+
+    void VMapManager2::isInLineOfSight(unsigned int pMapId, LineOfSightQuery* queries, uint32 count)
+    {
+        for (uint32 i = 0; i < count; ++i)
+            queries[i].result = true;
+
+        if (!isLineOfSightCalcEnabled() || !count)
+            return;
+
+        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+        if (instanceTree == iInstanceMapTrees.end())
+            return;
+
+        std::vector<Vector3> pos1(count);
+        std::vector<Vector3> pos2(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            pos1[i] = convertPositionToInternalRep(queries[i].srcX, queries[i].srcY, queries[i].srcZ);
+            pos2[i] = convertPositionToInternalRep(queries[i].destX, queries[i].destY, queries[i].destZ);
+        }
+
+        bool* results = new bool[count];
+        instanceTree->second->isInLineOfSight(&pos1[0], &pos2[0], count, results);
+
+        for (uint32 i = 0; i < count; ++i)
+            queries[i].result = results[i];
+
+        delete[] results;
+    }
     //=========================================================
     /**
     get the hit position and return true if we hit something
@@ -278,6 +278,14 @@ void ChatHandler::HandleCharacterDeletedRestoreHelper(DeletedInfo const& delInfo
 
     CharacterDatabase.PExecute("UPDATE characters SET name='%s', account='%u', deleteDate=NULL, deleteInfos_Name=NULL, deleteInfos_Account=NULL WHERE deleteDate IS NOT NULL AND guid = %u",
                                delInfo.name.c_str(), delInfo.accountId, delInfo.lowguid);
+
+    CharacterNameData nameData;
+    if (sObjectMgr.GetCharacterNameData(delInfo.lowguid, nameData))
+    {
+        nameData.name = delInfo.name;
+        nameData.account = delInfo.accountId;
+        sObjectMgr.SetCharacterNameData(delInfo.lowguid, nameData);
+    }
 }
 
 /**
@@ -21,8 +21,12 @@
 #include <string.h>
 
 #include "DBCFileLoader.h"
+#include "ace/Mem_Map.h"
 
-DBCFileLoader::DBCFileLoader()
+// signature, record count, field count, record size, string block size
+#define DBC_HEADER_SIZE (5 * sizeof(uint32))
+
+DBCFileLoader::DBCFileLoader() : mapping(NULL)
 {
     data = NULL;
     fieldsOffset = NULL;
@@ -30,38 +34,42 @@ DBCFileLoader::DBCFileLoader()
 
 bool DBCFileLoader::Load(const char* filename, const char* fmt)
 {
-    uint32 header;
-    delete[] data;
-
-    FILE* f = fopen(filename, "rb");
-    if (!f)return false;
-
-    if (fread(&header, 4, 1, f) != 1)                       // Number of records
-        return false;
+    Unload();
 
-    EndianConvert(header);
-    if (header != 0x43424457)
-        return false;                                       //'WDBC'
-
-    if (fread(&recordCount, 4, 1, f) != 1)                  // Number of records
+    // private mapping: pages are shared with other processes reading the file until
+    // some code modifies a record in place, only that page gets a private copy
+    mapping = new ACE_Mem_Map();
+    if (mapping->map(ACE_TEXT_CHAR_TO_TCHAR(filename), static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_RDWR, ACE_MAP_PRIVATE) != 0 ||
+            mapping->size() < DBC_HEADER_SIZE)
+    {
+        Unload();
         return false;
+    }
 
-    EndianConvert(recordCount);
-
-    if (fread(&fieldCount, 4, 1, f) != 1)                   // Number of fields
-        return false;
+    // the mapping stays valid without the file, don't keep a descriptor open for every store
+    mapping->close_handle();
 
-    EndianConvert(fieldCount);
+    uint32 header[5];
+    memcpy(header, mapping->addr(), DBC_HEADER_SIZE);
+    for (int i = 0; i < 5; ++i)
+        EndianConvert(header[i]);
 
-    if (fread(&recordSize, 4, 1, f) != 1)                   // Size of a record
+    if (header[0] != 0x43424457)                            //'WDBC'
+    {
+        Unload();
         return false;
+    }
 
-    EndianConvert(recordSize);
+    recordCount = header[1];                                // Number of records
+    fieldCount = header[2];                                 // Number of fields
+    recordSize = header[3];                                 // Size of a record
+    stringSize = header[4];                                 // String size
 
-    if (fread(&stringSize, 4, 1, f) != 1)                   // String size
+    if (!fieldCount || mapping->size() < DBC_HEADER_SIZE + size_t(recordSize) * recordCount + stringSize)
+    {
+        Unload();
         return false;
-
-    EndianConvert(stringSize);
+    }
 
     fieldsOffset = new uint32[fieldCount];
     fieldsOffset[0] = 0;
@@ -74,20 +82,31 @@ bool DBCFileLoader::Load(const char* filename, const char* fmt)
             fieldsOffset[i] += 4;
     }
 
-    data = new unsigned char[recordSize * recordCount + stringSize];
+    data = static_cast<unsigned char*>(mapping->addr()) + DBC_HEADER_SIZE;
     stringTable = data + recordSize * recordCount;
+    return true;
+}
 
-    if (fread(data, recordSize * recordCount + stringSize, 1, f) != 1)
-        return false;
+void DBCFileLoader::Unload()
+{
+    delete mapping;
+    mapping = NULL;
+    data = NULL;
 
-    fclose(f);
-    return true;
+    delete[] fieldsOffset;
+    fieldsOffset = NULL;
+}
+
+ACE_Mem_Map* DBCFileLoader::DetachMapping()
+{
+    ACE_Mem_Map* detached = mapping;
+    mapping = NULL;
+    return detached;
 }
 
 DBCFileLoader::~DBCFileLoader()
 {
-    delete[] data;
-    delete[] fieldsOffset;
+    Unload();
 }
 
 DBCFileLoader::Record DBCFileLoader::getRecord(size_t id)
@@ -154,7 +173,6 @@ char* DBCFileLoader::AutoProduceData(const char* format, uint32& records, char**
     this func will generate  entry[rows] data;
     */
 
-    typedef char* ptr;
     if (strlen(format) != fieldCount)
         return NULL;
 
@@ -162,26 +180,7 @@ char* DBCFileLoader::AutoProduceData(const char* format, uint32& records, char**
     int32 i;
     uint32 recordsize = GetFormatRecordSize(format, &i);
 
-    if (i >= 0)
-    {
-        uint32 maxi = 0;
-        // find max index
-        for (uint32 y = 0; y < recordCount; ++y)
-        {
-            uint32 ind = getRecord(y).getUInt(i);
-            if (ind > maxi)maxi = ind;
-        }
-
-        ++maxi;
-        records = maxi;
-        indexTable = new ptr[maxi];
-        memset(indexTable, 0, maxi * sizeof(ptr));
-    }
-    else
-    {
-        records = recordCount;
-        indexTable = new ptr[recordCount];
-    }
+    indexTable = CreateIndexTable(i, records);
 
     char* dataTable = new char[recordCount * recordsize];
 
@@ -234,13 +233,10 @@ char* DBCFileLoader::AutoProduceData(const char* format, uint32& records, char**
     return dataTable;
 }
 
-char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
+void DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
 {
     if (strlen(format) != fieldCount)
-        return NULL;
-
-    char* stringPool = new char[stringSize];
-    memcpy(stringPool, stringTable, stringSize);
+        return;
 
     uint32 offset = 0;
 
@@ -265,10 +261,7 @@ char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
                     // fill only not filled entries
                     char** slot = (char**)(&dataTable[offset]);
                     if (!*slot || !** slot)
-                    {
-                        const char* st = getRecord(y).getString(x);
-                        *slot = stringPool + (st - (const char*)stringTable);
-                    }
+                        *slot = const_cast<char*>(getRecord(y).getString(x));
                     offset += sizeof(char*);
                     break;
                 }
@@ -285,6 +278,61 @@ char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
             }
         }
     }
+}
+
+char** DBCFileLoader::CreateIndexTable(int32 indexPos, uint32& records)
+{
+    typedef char* ptr;
+
+    if (indexPos < 0)
+    {
+        records = recordCount;
+        return new ptr[recordCount];
+    }
+
+    uint32 maxi = 0;
+    // find max index
+    for (uint32 y = 0; y < recordCount; ++y)
+    {
+        uint32 ind = getRecord(y).getUInt(indexPos);
+        if (ind > maxi)maxi = ind;
+    }
+
+    ++maxi;
+    records = maxi;
+    ptr* indexTable = new ptr[maxi];
+    memset(indexTable, 0, maxi * sizeof(ptr));
+    return indexTable;
+}
+
+char* DBCFileLoader::AutoProduceMappedData(const char* format, uint32& records, char**& indexTable)
+{
+#if MANGOS_ENDIAN == MANGOS_BIGENDIAN
+    // file data is little endian and needs conversion
+    return NULL;
+#else
+    if (strlen(format) != fieldCount || recordSize != fieldCount * sizeof(uint32))
+        return NULL;
+
+    // only 4 byte number fields have the same layout in file and structure
+    for (uint32 x = 0; x < fieldCount; ++x)
+        if (format[x] != FT_INT && format[x] != FT_IND && format[x] != FT_FLOAT)
+            return NULL;
+
+    int32 i;
+    GetFormatRecordSize(format, &i);
+
+    indexTable = CreateIndexTable(i, records);
+
+    for (uint32 y = 0; y < recordCount; ++y)
+    {
+        char* record = reinterpret_cast<char*>(data + y * recordSize);
+        if (i >= 0)
+            indexTable[getRecord(y).getUInt(i)] = record;
+        else
+            indexTable[y] = record;
+    }
 
-    return stringPool;
+    return reinterpret_cast<char*>(data);
+#endif
 }
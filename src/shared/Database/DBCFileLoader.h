@@ -37,6 +37,16 @@ enum FieldFormat
     FT_LOGIC = 'l'                                          // Logical (boolean)
 };
 
+class ACE_Mem_Map;
+
+/**
+ * Reads DBC files through a private (copy-on-write) file mapping.
+ *
+ * Unmodified pages of the mapping are shared with the page cache, so the file data is not copied
+ * to the heap. Stores whose C++ record layout matches the file layout use the records in place,
+ * string fields of all other stores point into the mapped string block. Such pointers stay valid
+ * only as long as the mapping obtained by DetachMapping() is kept.
+ */
 class DBCFileLoader
 {
     public:
@@ -93,9 +103,18 @@ class DBCFileLoader
         uint32 GetOffset(size_t id) const { return (fieldsOffset != NULL && id < fieldCount) ? fieldsOffset[id] : 0; }
         bool IsLoaded() {return (data != NULL);}
         char* AutoProduceData(const char* fmt, uint32& count, char**& indexTable);
-        char* AutoProduceStrings(const char* fmt, char* dataTable);
+        // index the records inside the mapped file if their layout matches fmt, returns NULL if they need conversion by AutoProduceData
+        char* AutoProduceMappedData(const char* fmt, uint32& count, char**& indexTable);
+        // set the string fields of dataTable to the strings inside the mapped file
+        void AutoProduceStrings(const char* fmt, char* dataTable);
+        // hand over the file mapping to the caller, it has to be kept while produced data is in use
+        ACE_Mem_Map* DetachMapping();
         static uint32 GetFormatRecordSize(const char* format, int32* index_pos = NULL);
     private:
+        void Unload();
+        char** CreateIndexTable(int32 indexPos, uint32& records);
+
+        ACE_Mem_Map* mapping;
 
         uint32 recordSize;
         uint32 recordCount;
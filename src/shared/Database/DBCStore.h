@@ -20,11 +20,12 @@
 #define DBCSTORE_H
 
 #include "DBCFileLoader.h"
+#include "ace/Mem_Map.h"
 
 template<class T>
 class DBCStorage
 {
-        typedef std::list<char*> StringPoolList;
+        typedef std::list<ACE_Mem_Map*> FileMappingList;
     public:
         explicit DBCStorage(const char* f) : nCount(0), fieldCount(0), fmt(f), indexTable(NULL), m_dataTable(NULL) { }
         ~DBCStorage() { Clear(); }
@@ -43,11 +44,18 @@ class DBCStorage
 
             fieldCount = dbc.GetCols();
 
-            // load raw non-string data
-            m_dataTable = (T*)dbc.AutoProduceData(fmt, nCount, (char**&)indexTable);
+            // records with the same layout as the file are used in place, they have no strings
+            if (!dbc.AutoProduceMappedData(fmt, nCount, (char**&)indexTable))
+            {
+                // load raw non-string data
+                m_dataTable = (T*)dbc.AutoProduceData(fmt, nCount, (char**&)indexTable);
+
+                // load strings from dbc data
+                dbc.AutoProduceStrings(fmt, (char*)m_dataTable);
+            }
 
-            // load strings from dbc data
-            m_stringPoolList.push_back(dbc.AutoProduceStrings(fmt, (char*)m_dataTable));
+            // records and strings point into the file mapping
+            m_fileMappingList.push_back(dbc.DetachMapping());
 
             // error in dbc file at loading if NULL
             return indexTable != NULL;
@@ -59,13 +67,18 @@ class DBCStorage
             if (!indexTable)
                 return false;
 
+            // used in place from the file, no string fields
+            if (!m_dataTable)
+                return true;
+
             DBCFileLoader dbc;
             // Check if load was successful, only then continue
             if (!dbc.Load(fn, fmt))
                 return false;
 
             // load strings from another locale dbc data
-            m_stringPoolList.push_back(dbc.AutoProduceStrings(fmt, (char*)m_dataTable));
+            dbc.AutoProduceStrings(fmt, (char*)m_dataTable);
+            m_fileMappingList.push_back(dbc.DetachMapping());
 
             return true;
         }
@@ -80,10 +93,10 @@ class DBCStorage
             delete[]((char*)m_dataTable);
             m_dataTable = NULL;
 
-            while (!m_stringPoolList.empty())
+            while (!m_fileMappingList.empty())
             {
-                delete[] m_stringPoolList.front();
-                m_stringPoolList.pop_front();
+                delete m_fileMappingList.front();
+                m_fileMappingList.pop_front();
             }
             nCount = 0;
         }
@@ -97,7 +110,7 @@ class DBCStorage
         char const* fmt;
         T** indexTable;
         T* m_dataTable;
-        StringPoolList m_stringPoolList;
+        FileMappingList m_fileMappingList;
 };
 
 #endif
@@ -47,33 +47,44 @@ void SqlConnection::FreePreparedStatements()
 
 SqlPreparedStatement* SqlConnection::GetStmt(uint32 nIndex)
 {
-    // resize stmt container
-    if (m_holder.size() <= nIndex)
-        m_holder.resize(nIndex + 1, NULL);
+    if (nIndex < m_holder.size() && m_holder[nIndex])
+        return m_holder[nIndex];
+
+    // obtain SQL request string
+    std::string fmt = m_db.GetStmtString(nIndex);
+    MANGOS_ASSERT(fmt.length());
+    // allocate SQlPreparedStatement object
+    SqlPreparedStatement* pStmt = CreateStatement(fmt);
+    // prepare statement
+    if (!pStmt->prepare())
+    {
+        delete pStmt;
+        pStmt = NULL;
 
-    SqlPreparedStatement* pStmt = NULL;
+        // connection may be lost since the last request, prepare again on a new one
+        if (HandleLostConnection())
+        {
+            pStmt = CreateStatement(fmt);
+            if (!pStmt->prepare())
+            {
+                delete pStmt;
+                pStmt = NULL;
+            }
+        }
 
-    // create stmt if needed
-    if (m_holder[nIndex] == NULL)
-    {
-        // obtain SQL request string
-        std::string fmt = m_db.GetStmtString(nIndex);
-        MANGOS_ASSERT(fmt.length());
-        // allocate SQlPreparedStatement object
-        pStmt = CreateStatement(fmt);
-        // prepare statement
-        if (!pStmt->prepare())
+        if (!pStmt)
         {
             MANGOS_ASSERT(false && "Unable to prepare SQL statement");
             return NULL;
         }
-
-        // save statement in internal registry
-        m_holder[nIndex] = pStmt;
     }
-    else
-        pStmt = m_holder[nIndex];
 
+    // resize stmt container, reconnecting above may have cleared it
+    if (m_holder.size() <= nIndex)
+        m_holder.resize(nIndex + 1, NULL);
+
+    // save statement in internal registry
+    m_holder[nIndex] = pStmt;
     return pStmt;
 }
 
@@ -84,9 +95,23 @@ bool SqlConnection::ExecuteStmt(int nIndex, const SqlStmtParameters& id)
 
     // get prepared statement object
     SqlPreparedStatement* pStmt = GetStmt(nIndex);
+    if (!pStmt)
+        return false;
     // bind parameters
     pStmt->bind(id);
     // execute statement
+    if (pStmt->execute())
+        return true;
+
+    // prepared statements are freed with a lost connection, GetStmt() prepares the statement again on the new one
+    if (!HandleLostConnection())
+        return false;
+
+    pStmt = GetStmt(nIndex);
+    if (!pStmt)
+        return false;
+
+    pStmt->bind(id);
     return pStmt->execute();
 }
 
@@ -96,7 +121,7 @@ Database::~Database()
     StopServer();
 }
 
-bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
+bool Database::Initialize(const char* infoString, int nConns /*= 1*/, int nAsyncConns /*= 1*/)
 {
     // Enable logging of SQL commands (usually only GM commands)
     // (See method: PExecuteLog)
@@ -133,10 +158,25 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
         m_pQueryConnections.push_back(pConn);
     }
 
-    // create and initialize connection for async requests
-    m_pAsyncConn = CreateConnection();
-    if (!m_pAsyncConn->Initialize(infoString))
-        return false;
+    // create and initialize connections for async requests
+    if (nAsyncConns < MIN_CONNECTION_POOL_SIZE)
+        nAsyncConns = MIN_CONNECTION_POOL_SIZE;
+    else if (nAsyncConns > MAX_CONNECTION_POOL_SIZE)
+        nAsyncConns = MAX_CONNECTION_POOL_SIZE;
+
+    for (int i = 0; i < nAsyncConns; ++i)
+    {
+        SqlConnection* pConn = CreateConnection();
+        if (!pConn->Initialize(infoString))
+        {
+            delete pConn;
+            return false;
+        }
+
+        m_pAsyncConns.push_back(pConn);
+    }
+
+    m_pAsyncConn = m_pAsyncConns[0];
 
     m_pResultQueue = new SqlResultQueue;
 
@@ -149,9 +189,12 @@ void Database::StopServer()
     HaltDelayThread();
 
     delete m_pResultQueue;
-    delete m_pAsyncConn;
-
     m_pResultQueue = NULL;
+
+    for (size_t i = 0; i < m_pAsyncConns.size(); ++i)
+        delete m_pAsyncConns[i];
+
+    m_pAsyncConns.clear();
     m_pAsyncConn = NULL;
 
     for (size_t i = 0; i < m_pQueryConnections.size(); ++i)
@@ -160,30 +203,53 @@ void Database::StopServer()
     m_pQueryConnections.clear();
 }
 
-SqlDelayThread* Database::CreateDelayThread()
+SqlDelayThread* Database::CreateDelayThread(SqlConnection* conn, bool pingDatabase)
 {
-    assert(m_pAsyncConn);
-    return new SqlDelayThread(this, m_pAsyncConn);
+    assert(conn);
+    return new SqlDelayThread(this, conn, m_delayQueue, pingDatabase);
 }
 
 void Database::InitDelayThread()
 {
-    assert(!m_delayThread);
+    assert(!m_delayQueue);
 
-    // New delay thread for delay execute
-    m_threadBody = CreateDelayThread();              // will deleted at m_delayThread delete
-    m_delayThread = new ACE_Based::Thread(m_threadBody);
+    m_delayQueue = new SqlDelayQueue;
+
+    // New delay threads for delay execute, the first one also pings all connections
+    for (size_t i = 0; i < m_pAsyncConns.size(); ++i)
+        m_delayThreads.push_back(new ACE_Based::Thread(CreateDelayThread(m_pAsyncConns[i], i == 0)));
 }
 
 void Database::HaltDelayThread()
 {
-    if (!m_threadBody || !m_delayThread) return;
+    if (!m_delayQueue) return;
+
+    m_delayQueue->Stop();                                   // Stop event
+
+    for (size_t i = 0; i < m_delayThreads.size(); ++i)
+    {
+        m_delayThreads[i]->wait();                          // Wait for flush to DB
+        delete m_delayThreads[i];                           // This also deletes the thread body
+    }
 
-    m_threadBody->Stop();                                   // Stop event
-    m_delayThread->wait();                                  // Wait for flush to DB
-    delete m_delayThread;                                   // This also deletes m_threadBody
-    m_delayThread = NULL;
-    m_threadBody = NULL;
+    m_delayThreads.clear();
+
+    // requests queued while the threads were stopping
+    SqlDelayQueue::Request request;
+    while (m_delayQueue->Next(request, 0))
+    {
+        request.sql->Execute(m_pAsyncConn);
+        delete request.sql;
+        m_delayQueue->Finish(request);
+    }
+
+    delete m_delayQueue;
+    m_delayQueue = NULL;
+}
+
+SqlDelayQueueStats Database::GetAsyncQueueStats(bool reset /*= false*/)
+{
+    return m_delayQueue ? m_delayQueue->GetStats(reset) : SqlDelayQueueStats();
 }
 
 void Database::ThreadStart()
@@ -228,8 +294,9 @@ void Database::Ping()
 {
     const char* sql = "SELECT 1";
 
+    for (size_t i = 0; i < m_pAsyncConns.size(); ++i)
     {
-        SqlConnection::Lock guard(m_pAsyncConn);
+        SqlConnection::Lock guard(m_pAsyncConns[i]);
         delete guard->Query(sql);
     }
 
@@ -340,7 +407,7 @@ bool Database::Execute(const char* sql)
             return DirectExecute(sql);
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPlainRequest(sql));
+        Delay(new SqlPlainRequest(sql));
     }
 
     return true;
@@ -411,7 +478,7 @@ bool Database::CommitTransaction()
         return CommitTransactionDirect();
 
     // add SqlTransaction to the async queue
-    m_threadBody->Delay(m_TransStorage->detach());
+    Delay(m_TransStorage->detach());
     return true;
 }
 
@@ -432,6 +499,18 @@ bool Database::CommitTransactionDirect()
     return true;
 }
 
+void Database::GetTransactionSize(uint32& statements, uint32& bytes)
+{
+    statements = 0;
+    bytes = 0;
+
+    if (SqlTransaction* pTrans = m_TransStorage->get())
+    {
+        statements = pTrans->GetStatementsCount();
+        bytes = pTrans->DataSize();
+    }
+}
+
 bool Database::RollbackTransaction()
 {
     if (!m_pAsyncConn)
@@ -552,7 +631,7 @@ bool Database::ExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params)
             return DirectExecuteStmt(id, params);
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPreparedRequest(id.ID(), params));
+        Delay(new SqlPreparedRequest(id.ID(), params));
     }
 
     return true;
@@ -34,6 +34,7 @@ class SqlQueryHolder;
 class SqlStmtParameters;
 class SqlParamBinder;
 class Database;
+class SqlOperation;
 
 #define MAX_QUERY_LEN   (32*1024)
 
@@ -64,6 +65,10 @@ class MANGOS_DLL_SPEC SqlConnection
         // methods to work with prepared statements
         bool ExecuteStmt(int nIndex, const SqlStmtParameters& id);
 
+        // called after a failed request: reconnect if the server connection was lost
+        // returns true if the failed request can be repeated on the new connection
+        virtual bool HandleLostConnection() { return false; }
+
         // SqlConnection object lock
         class Lock
         {
@@ -105,10 +110,10 @@ class MANGOS_DLL_SPEC Database
     public:
         virtual ~Database();
 
-        virtual bool Initialize(const char* infoString, int nConns = 1);
-        // start worker thread for async DB request execution
+        virtual bool Initialize(const char* infoString, int nConns = 1, int nAsyncConns = 1);
+        // start worker threads for async DB request execution, one for each async connection
         virtual void InitDelayThread();
-        // stop worker thread
+        // stop worker threads after all queued requests are executed
         virtual void HaltDelayThread();
 
         /// Synchronous DB queries
@@ -189,6 +194,8 @@ class MANGOS_DLL_SPEC Database
         bool RollbackTransaction();
         // for sync transaction execution
         bool CommitTransactionDirect();
+        // statements and data size queued so far in the transaction opened by this thread
+        void GetTransactionSize(uint32& statements, uint32& bytes);
 
         // PREPARED STATEMENT API
 
@@ -216,6 +223,14 @@ class MANGOS_DLL_SPEC Database
         // function to ping database connections
         void Ping();
 
+        // async requests queued by the current thread are ordered only with other requests of the same key,
+        // see SqlDelayQueue. 0 (default) - strict ordering with all other requests
+        void SetAsyncOrderKey(uint64 key) { *m_asyncOrderKey = key; }
+        uint64 GetAsyncOrderKey() const { return *m_asyncOrderKey; }
+
+        // depth and latency of the async request queue, reset - start a new measurement period
+        SqlDelayQueueStats GetAsyncQueueStats(bool reset = false);
+
         // set this to allow async transactions
         // you should call it explicitly after your server successfully started up
         // NO ASYNC TRANSACTIONS DURING SERVER STARTUP - ONLY DURING RUNTIME!!!
@@ -224,7 +239,7 @@ class MANGOS_DLL_SPEC Database
     protected:
         Database() :
             m_nQueryConnPoolSize(1), m_pAsyncConn(NULL), m_pResultQueue(NULL),
-            m_threadBody(NULL), m_delayThread(NULL), m_bAllowAsyncTransactions(false),
+            m_delayQueue(NULL), m_bAllowAsyncTransactions(false),
             m_iStmtIndex(-1), m_logSQL(false), m_pingIntervallms(0)
         {
             m_nQueryCounter = -1;
@@ -235,7 +250,10 @@ class MANGOS_DLL_SPEC Database
         // factory method to create SqlConnection objects
         virtual SqlConnection* CreateConnection() = 0;
         // factory method to create SqlDelayThread objects
-        virtual SqlDelayThread* CreateDelayThread();
+        virtual SqlDelayThread* CreateDelayThread(SqlConnection* conn, bool pingDatabase);
+
+        // queue async request with the order key of the current thread
+        bool Delay(SqlOperation* sql) { return m_delayQueue->Delay(sql, GetAsyncOrderKey()); }
 
         class MANGOS_DLL_SPEC TransHelper
         {
@@ -266,7 +284,7 @@ class MANGOS_DLL_SPEC Database
 
         // round-robin connection selection
         SqlConnection* getQueryConnection();
-        // for now return one single connection for async requests
+        // connection for direct execution of requests normally done async
         SqlConnection* getAsyncConnection() const { return m_pAsyncConn; }
 
         friend class SqlStatement;
@@ -283,12 +301,19 @@ class MANGOS_DLL_SPEC Database
         typedef std::vector< SqlConnection* > SqlConnectionContainer;
         SqlConnectionContainer m_pQueryConnections;
 
-        // only one single DB connection for transactions
+        // pool of connections for async requests and transactions, each used by its own delay thread
+        SqlConnectionContainer m_pAsyncConns;
+        // first async connection, also used for direct execution
         SqlConnection* m_pAsyncConn;
 
         SqlResultQueue*     m_pResultQueue;                 ///< Transaction queues from diff. threads
-        SqlDelayThread*     m_threadBody;                   ///< Pointer to delay sql executer (owned by m_delayThread)
-        ACE_Based::Thread* m_delayThread;                   ///< Pointer to executer thread
+        SqlDelayQueue*      m_delayQueue;                   ///< Requests waiting for the delay threads
+
+        typedef std::vector<ACE_Based::Thread*> DelayThreads;
+        DelayThreads m_delayThreads;                        ///< Executer threads, one for each async connection
+
+        typedef ACE_TSS<ACE_TSS_Type_Adapter<uint64> > AsyncOrderKeyTSS;
+        mutable AsyncOrderKeyTSS m_asyncOrderKey;           ///< order key for async requests of the current thread
 
         bool m_bAllowAsyncTransactions;                     ///< flag which specifies if async transactions are enabled
 
@@ -309,4 +334,15 @@ class MANGOS_DLL_SPEC Database
         std::string m_logsDir;
         uint32 m_pingIntervallms;
 };
+/// Sets the async order key of the current thread for the lifetime of the guard
+class MANGOS_DLL_SPEC SqlAsyncOrderGuard
+{
+    public:
+        SqlAsyncOrderGuard(Database& db, uint64 key) : m_db(db), m_prevKey(db.GetAsyncOrderKey()) { m_db.SetAsyncOrderKey(key); }
+        ~SqlAsyncOrderGuard() { m_db.SetAsyncOrderKey(m_prevKey); }
+
+    private:
+        Database& m_db;
+        uint64 const m_prevKey;
+};
 #endif
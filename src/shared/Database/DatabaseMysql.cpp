@@ -75,6 +75,18 @@ MySQLConnection::~MySQLConnection()
 }
 
 bool MySQLConnection::Initialize(const char* infoString)
+{
+    m_infoString = infoString;
+
+    if (!_Connect())
+        return false;
+
+    sLog.outString("MySQL client library: %s", mysql_get_client_info());
+    sLog.outString("MySQL server ver: %s ", mysql_get_server_info(mMysql));
+    return true;
+}
+
+bool MySQLConnection::_Connect()
 {
     MYSQL* mysqlInit = mysql_init(NULL);
     if (!mysqlInit)
@@ -83,7 +95,7 @@ bool MySQLConnection::Initialize(const char* infoString)
         return false;
     }
 
-    Tokens tokens = StrSplit(infoString, ";");
+    Tokens tokens = StrSplit(m_infoString, ";");
 
     Tokens::iterator iter;
 
@@ -146,8 +158,6 @@ bool MySQLConnection::Initialize(const char* infoString)
     }
 
     DETAIL_LOG("Connected to MySQL database %s@%s:%s/%s", user.c_str(), host.c_str(), port_or_socket.c_str(), database.c_str());
-    sLog.outString("MySQL client library: %s", mysql_get_client_info());
-    sLog.outString("MySQL server ver: %s ", mysql_get_server_info(mMysql));
 
     /*----------SET AUTOCOMMIT ON---------*/
     // It seems mysql 5.0.x have enabled this feature
@@ -168,23 +178,55 @@ bool MySQLConnection::Initialize(const char* infoString)
 
     // set connection properties to UTF8 to properly handle locales for different
     // server configs - core sends data in UTF8, so MySQL must expect UTF8 too
-    Execute("SET NAMES `utf8`");
-    Execute("SET CHARACTER SET `utf8`");
+    // (not through Execute(), a failure here must not start another reconnect)
+    mysql_query(mMysql, "SET NAMES `utf8`");
+    mysql_query(mMysql, "SET CHARACTER SET `utf8`");
 
     return true;
 }
 
-bool MySQLConnection::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD** pFields, uint64* pRowCount, uint32* pFieldCount)
+bool MySQLConnection::HandleLostConnection()
 {
-    if (!mMysql)
-        return 0;
+    // the server rolls back an open transaction with the connection, only the complete
+    // transaction can be repeated and that is done after RollbackTransaction()
+    if (m_inTransaction)
+        return false;
 
+    // connection is alive, the request failed for another reason
+    if (mMysql && !mysql_ping(mMysql))
+        return false;
+
+    sLog.outError("SQL: connection to MySQL server lost, reconnecting...");
+
+    // statements are bound to the old connection handle, they are prepared again on next use
+    FreePreparedStatements();
+
+    if (mMysql)
+    {
+        mysql_close(mMysql);
+        mMysql = NULL;
+    }
+
+    return _Connect();
+}
+
+bool MySQLConnection::_SendQuery(const char* sql)
+{
+    if (mMysql && !mysql_query(mMysql, sql))
+        return true;
+
+    // repeat once if the failure was caused by a lost connection
+    return HandleLostConnection() && !mysql_query(mMysql, sql);
+}
+
+bool MySQLConnection::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD** pFields, uint64* pRowCount, uint32* pFieldCount)
+{
     uint32 _s = WorldTimer::getMSTime();
 
-    if (mysql_query(mMysql, sql))
+    if (!_SendQuery(sql))
     {
         sLog.outErrorDb("SQL: %s", sql);
-        sLog.outErrorDb("query ERROR: %s", mysql_error(mMysql));
+        sLog.outErrorDb("query ERROR: %s", mMysql ? mysql_error(mMysql) : "no connection");
         return false;
     }
     else
@@ -247,16 +289,13 @@ QueryNamedResult* MySQLConnection::QueryNamed(const char* sql)
 
 bool MySQLConnection::Execute(const char* sql)
 {
-    if (!mMysql)
-        return false;
-
     {
         uint32 _s = WorldTimer::getMSTime();
 
-        if (mysql_query(mMysql, sql))
+        if (!_SendQuery(sql))
         {
             sLog.outErrorDb("SQL: %s", sql);
-            sLog.outErrorDb("SQL ERROR: %s", mysql_error(mMysql));
+            sLog.outErrorDb("SQL ERROR: %s", mMysql ? mysql_error(mMysql) : "no connection");
             return false;
         }
         else
@@ -271,10 +310,10 @@ bool MySQLConnection::Execute(const char* sql)
 
 bool MySQLConnection::_TransactionCmd(const char* sql)
 {
-    if (mysql_query(mMysql, sql))
+    if (!mMysql || mysql_query(mMysql, sql))
     {
         sLog.outError("SQL: %s", sql);
-        sLog.outError("SQL ERROR: %s", mysql_error(mMysql));
+        sLog.outError("SQL ERROR: %s", mMysql ? mysql_error(mMysql) : "no connection");
         return false;
     }
     else
@@ -286,16 +325,20 @@ bool MySQLConnection::_TransactionCmd(const char* sql)
 
 bool MySQLConnection::BeginTransaction()
 {
+    // set even on failure, requests of the transaction must not be repeated one by one in autocommit mode
+    m_inTransaction = true;
     return _TransactionCmd("START TRANSACTION");
 }
 
 bool MySQLConnection::CommitTransaction()
 {
+    m_inTransaction = false;
     return _TransactionCmd("COMMIT");
 }
 
 bool MySQLConnection::RollbackTransaction()
 {
+    m_inTransaction = false;
     return _TransactionCmd("ROLLBACK");
 }
 
@@ -332,6 +375,9 @@ bool MySqlPreparedStatement::prepare()
     // remove old binds
     RemoveBinds();
 
+    if (!m_pMySQLConn)
+        return false;
+
     // create statement object
     m_stmt = mysql_stmt_init(m_pMySQLConn);
     if (!m_stmt)
@@ -69,7 +69,7 @@ class MANGOS_DLL_SPEC MySqlPreparedStatement : public SqlPreparedStatement
 class MANGOS_DLL_SPEC MySQLConnection : public SqlConnection
 {
     public:
-        MySQLConnection(Database& db) : SqlConnection(db), mMysql(NULL) {}
+        MySQLConnection(Database& db) : SqlConnection(db), mMysql(NULL), m_inTransaction(false) {}
         ~MySQLConnection();
 
         //! Initializes Mysql and connects to a server.
@@ -86,14 +86,20 @@ class MANGOS_DLL_SPEC MySQLConnection : public SqlConnection
         bool CommitTransaction() override;
         bool RollbackTransaction() override;
 
+        bool HandleLostConnection() override;
+
     protected:
         SqlPreparedStatement* CreateStatement(const std::string& fmt) override;
 
     private:
+        bool _Connect();
+        bool _SendQuery(const char* sql);
         bool _TransactionCmd(const char* sql);
         bool _Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD** pFields, uint64* pRowCount, uint32* pFieldCount);
 
         MYSQL* mMysql;
+        std::string m_infoString;                           ///< kept to reconnect after the server connection was lost
+        bool m_inTransaction;
 };
 
 class MANGOS_DLL_SPEC DatabaseMysql : public Database
@@ -19,59 +19,183 @@
 #include "Database/SqlDelayThread.h"
 #include "Database/SqlOperations.h"
 #include "DatabaseEnv.h"
+#include "Timer.h"
 
-SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn) : m_dbEngine(db), m_dbConnection(conn), m_running(true)
+SqlDelayQueue::SqlDelayQueue() : m_condition(m_lock), m_runningCount(0), m_barrierRunning(false), m_stopped(false), m_totalLatency(0)
 {
 }
 
-SqlDelayThread::~SqlDelayThread()
+SqlDelayQueue::~SqlDelayQueue()
 {
-    // process all requests which might have been queued while thread was stopping
-    ProcessRequests();
+    MANGOS_ASSERT(m_requests.empty() && !m_runningCount);
 }
 
-void SqlDelayThread::run()
+bool SqlDelayQueue::Delay(SqlOperation* sql, uint64 orderKey)
 {
-#ifndef DO_POSTGRESQL
-    mysql_thread_init();
-#endif
+    Request request;
+    request.sql = sql;
+    request.orderKey = orderKey;
+    request.queueTime = WorldTimer::getMSTime();
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, false);
 
-    const uint32 loopSleepms = 10;
+    m_requests.push_back(request);
 
-    const uint32 pingEveryLoop = m_dbEngine->GetPingIntervall() / loopSleepms;
+    if (++m_stats.queued > m_stats.maxQueued)
+        m_stats.maxQueued = m_stats.queued;
+
+    m_condition.signal();
+    return true;
+}
+
+SqlDelayQueue::RequestList::iterator SqlDelayQueue::FindRunnable()
+{
+    if (m_barrierRunning)
+        return m_requests.end();
 
-    uint32 loopCounter = 0;
-    while (m_running)
+    for (RequestList::iterator itr = m_requests.begin(); itr != m_requests.end(); ++itr)
     {
-        // if the running state gets turned off while sleeping
-        // empty the queue before exiting
-        ACE_Based::Thread::Sleep(loopSleepms);
+        // requests without order key run alone, and nothing queued after them may pass
+        if (!itr->orderKey)
+            return (itr == m_requests.begin() && !m_runningCount) ? itr : m_requests.end();
 
-        ProcessRequests();
+        // an earlier request of the same key is in execution, following ones of that key are skipped as well
+        if (m_runningKeys.find(itr->orderKey) == m_runningKeys.end())
+            return itr;
+    }
+
+    return m_requests.end();
+}
+
+bool SqlDelayQueue::Next(Request& request, uint32 waitMs)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, false);
+
+    ACE_Time_Value timeout = ACE_OS::gettimeofday() + ACE_Time_Value(waitMs / 1000, (waitMs % 1000) * 1000);
 
-        if ((loopCounter++) >= pingEveryLoop)
+    while (true)
+    {
+        RequestList::iterator itr = FindRunnable();
+        if (itr != m_requests.end())
         {
-            loopCounter = 0;
-            m_dbEngine->Ping();
+            request = *itr;
+            m_requests.erase(itr);
+
+            ++m_runningCount;
+            if (request.orderKey)
+                m_runningKeys.insert(request.orderKey);
+            else
+                m_barrierRunning = true;
+
+            return true;
+        }
+
+        // the remaining requests are executed by the other delay threads
+        if (m_stopped && m_requests.empty())
+            return false;
+
+        if (m_condition.wait(waitMs ? &timeout : NULL) == -1 && errno == ETIME)
+        {
+            request.sql = NULL;
+            return true;
         }
     }
+}
 
-#ifndef DO_POSTGRESQL
-    mysql_thread_end();
-#endif
+void SqlDelayQueue::Finish(Request const& request)
+{
+    uint32 latency = WorldTimer::getMSTimeDiff(request.queueTime, WorldTimer::getMSTime());
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    --m_runningCount;
+    if (request.orderKey)
+        m_runningKeys.erase(request.orderKey);
+    else
+        m_barrierRunning = false;
+
+    --m_stats.queued;
+    ++m_stats.executed;
+    m_totalLatency += latency;
+    if (latency > m_stats.maxLatency)
+        m_stats.maxLatency = latency;
+
+    // requests waiting for this one may run now, or stopping threads may exit
+    if (!m_requests.empty() || m_stopped)
+        m_condition.broadcast();
 }
 
-void SqlDelayThread::Stop()
+void SqlDelayQueue::Stop()
 {
-    m_running = false;
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    m_stopped = true;
+    m_condition.broadcast();
 }
 
-void SqlDelayThread::ProcessRequests()
+SqlDelayQueueStats SqlDelayQueue::GetStats(bool reset)
 {
-    SqlOperation* s = NULL;
-    while (m_sqlQueue.next(s))
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, SqlDelayQueueStats());
+
+    SqlDelayQueueStats stats = m_stats;
+    stats.avgLatency = m_stats.executed ? uint32(m_totalLatency / m_stats.executed) : 0;
+
+    if (reset)
+    {
+        m_stats.maxQueued = m_stats.queued;
+        m_stats.executed = 0;
+        m_stats.maxLatency = 0;
+        m_totalLatency = 0;
+    }
+
+    return stats;
+}
+
+SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn, SqlDelayQueue* queue, bool pingDatabase) :
+    m_queue(queue), m_dbEngine(db), m_dbConnection(conn), m_pingDatabase(pingDatabase)
+{
+}
+
+void SqlDelayThread::run()
+{
+#ifndef DO_POSTGRESQL
+    mysql_thread_init();
+#endif
+
+    const uint32 pingInterval = m_dbEngine->GetPingIntervall();
+    const bool pingDatabase = m_pingDatabase && pingInterval;
+    uint32 lastPing = WorldTimer::getMSTime();
+
+    SqlDelayQueue::Request request;
+
+    while (true)
     {
-        s->Execute(m_dbConnection);
-        delete s;
+        // sleep until a request arrives, the pinging thread wakes up at least for the next ping
+        uint32 waitMs = 0;
+        if (pingDatabase)
+        {
+            uint32 sinceLastPing = WorldTimer::getMSTimeDiff(lastPing, WorldTimer::getMSTime());
+            waitMs = sinceLastPing < pingInterval ? pingInterval - sinceLastPing : 1;
+        }
+
+        if (!m_queue->Next(request, waitMs))
+            break;                                          // stopped and all requests done
+
+        if (request.sql)
+        {
+            request.sql->Execute(m_dbConnection);
+            delete request.sql;
+            m_queue->Finish(request);
+        }
+
+        if (pingDatabase && WorldTimer::getMSTimeDiff(lastPing, WorldTimer::getMSTime()) >= pingInterval)
+        {
+            lastPing = WorldTimer::getMSTime();
+            m_dbEngine->Ping();
+        }
     }
+
+#ifndef DO_POSTGRESQL
+    mysql_thread_end();
+#endif
 }
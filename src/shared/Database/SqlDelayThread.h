@@ -19,35 +19,97 @@
 #ifndef __SQLDELAYTHREAD_H
 #define __SQLDELAYTHREAD_H
 
+#include "Common.h"
 #include "ace/Thread_Mutex.h"
-#include "LockedQueue.h"
+#include "ace/Condition_Thread_Mutex.h"
 #include "Threading.h"
 
+#include <list>
+#include <set>
+
 class Database;
 class SqlOperation;
 class SqlConnection;
 
-class SqlDelayThread : public ACE_Based::Runnable
+/// Statistics of the async request queue of a Database
+struct SqlDelayQueueStats
 {
-        typedef ACE_Based::LockedQueue<SqlOperation*, ACE_Thread_Mutex> SqlQueue;
+    SqlDelayQueueStats() : queued(0), maxQueued(0), executed(0), avgLatency(0), maxLatency(0) {}
+
+    uint32 queued;                                          ///< requests waiting or in execution
+    uint32 maxQueued;                                       ///< highest number of queued requests
+    uint64 executed;                                        ///< requests executed
+    uint32 avgLatency;                                      ///< average ms between queuing and end of execution
+    uint32 maxLatency;                                      ///< highest ms between queuing and end of execution
+};
+
+/**
+ * Queue of async requests shared by all delay threads of a Database.
+ *
+ * Requests with the same non zero order key are executed one at a time in queuing order,
+ * requests with different keys may run in parallel on different async connections.
+ * Requests without order key keep the strict ordering of a single async connection:
+ * they wait for all requests queued before them and block all requests queued after them.
+ */
+class SqlDelayQueue
+{
+    public:
+        struct Request
+        {
+            SqlOperation* sql;
+            uint64 orderKey;
+            uint32 queueTime;
+        };
+
+        SqlDelayQueue();
+        ~SqlDelayQueue();
+
+        ///< Put sql request to delay queue
+        bool Delay(SqlOperation* sql, uint64 orderKey);
+
+        // get the next request allowed to run, waits at most waitMs (0 - until something arrives)
+        // request.sql is NULL if the time passed first, returns false when stopped and no request is left
+        bool Next(Request& request, uint32 waitMs);
+        // must be called by the delay thread after execution of a request obtained by Next()
+        void Finish(Request const& request);
+
+        // delay threads finish the queued requests and stop
+        void Stop();
+
+        SqlDelayQueueStats GetStats(bool reset);
 
     private:
-        SqlQueue m_sqlQueue;                                ///< Queue of SQL statements
+        typedef std::list<Request> RequestList;
+        typedef std::set<uint64> OrderKeySet;
+
+        // find a request that may be executed now, m_lock must be held
+        RequestList::iterator FindRunnable();
+
+        ACE_Thread_Mutex m_lock;
+        ACE_Condition_Thread_Mutex m_condition;             ///< signaled when a request may have become runnable
+
+        RequestList m_requests;                             ///< requests not started yet, in queuing order
+        OrderKeySet m_runningKeys;                          ///< order keys of requests in execution
+        uint32 m_runningCount;
+        bool m_barrierRunning;                              ///< a request without order key is in execution
+        bool m_stopped;
+
+        SqlDelayQueueStats m_stats;
+        uint64 m_totalLatency;                              ///< sum of latencies of m_stats.executed requests
+};
+
+/// Executes requests of the delay queue on one async connection
+class SqlDelayThread : public ACE_Based::Runnable
+{
+    private:
+        SqlDelayQueue* m_queue;                             ///< Queue shared by all delay threads of the Database
         Database* m_dbEngine;                               ///< Pointer to used Database engine
         SqlConnection* m_dbConnection;                      ///< Pointer to DB connection
-        volatile bool m_running;
-
-        // process all enqueued requests
-        void ProcessRequests();
+        bool m_pingDatabase;                                ///< this thread keeps the connections of the Database alive
 
     public:
-        SqlDelayThread(Database* db, SqlConnection* conn);
-        ~SqlDelayThread();
-
-        ///< Put sql statement to delay queue
-        bool Delay(SqlOperation* sql) { m_sqlQueue.add(sql); return true; }
+        SqlDelayThread(Database* db, SqlConnection* conn, SqlDelayQueue* queue, bool pingDatabase);
 
-        virtual void Stop();                                ///< Stop event
         virtual void run();                                 ///< Main Thread loop
 };
 #endif                                                      //__SQLDELAYTHREAD_H
@@ -48,6 +48,27 @@ bool SqlTransaction::Execute(SqlConnection* conn)
 
     LOCK_DB_CONN(conn);
 
+    if (ExecuteOnce(conn))
+        return true;
+
+    // the server rolls back an open transaction when the connection is lost, so repeat it as a whole
+    if (!conn->HandleLostConnection())
+        return false;
+
+    return ExecuteOnce(conn);
+}
+
+size_t SqlTransaction::DataSize() const
+{
+    size_t size = 0;
+    for (std::vector<SqlOperation*>::const_iterator itr = m_queue.begin(); itr != m_queue.end(); ++itr)
+        size += (*itr)->DataSize();
+
+    return size;
+}
+
+bool SqlTransaction::ExecuteOnce(SqlConnection* conn)
+{
     conn->BeginTransaction();
 
     const int nItems = m_queue.size();
@@ -80,6 +101,16 @@ bool SqlPreparedRequest::Execute(SqlConnection* conn)
     return conn->ExecuteStmt(m_nIndex, *m_param);
 }
 
+size_t SqlPreparedRequest::DataSize() const
+{
+    size_t size = 0;
+    SqlStmtParameters::ParameterContainer const& params = m_param->params();
+    for (SqlStmtParameters::ParameterContainer::const_iterator itr = params.begin(); itr != params.end(); ++itr)
+        size += itr->size();
+
+    return size;
+}
+
 /// ---- ASYNC QUERIES ----
 
 bool SqlQuery::Execute(SqlConnection* conn)
@@ -107,15 +138,15 @@ void SqlResultQueue::Update()
     }
 }
 
-bool SqlQueryHolder::Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue)
+bool SqlQueryHolder::Execute(MaNGOS::IQueryCallback* callback, SqlDelayQueue* delayQueue, uint64 orderKey, SqlResultQueue* queue)
 {
-    if (!callback || !thread || !queue)
+    if (!callback || !delayQueue || !queue)
         return false;
 
     /// delay the execution of the queries, sync them with the delay thread
     /// which will in turn resync on execution (via the queue) and call back
     SqlQueryHolderEx* holderEx = new SqlQueryHolderEx(this, callback, queue);
-    thread->Delay(holderEx);
+    delayQueue->Delay(holderEx, orderKey);
     return true;
 }
 
@@ -30,7 +30,7 @@
 
 class Database;
 class SqlConnection;
-class SqlDelayThread;
+class SqlDelayQueue;
 class SqlStmtParameters;
 
 class SqlOperation
@@ -38,6 +38,8 @@ class SqlOperation
     public:
         virtual void OnRemove() { delete this; }
         virtual bool Execute(SqlConnection* conn) = 0;
+        // amount of statement data sent to the server, used for statistics only
+        virtual size_t DataSize() const { return 0; }
         virtual ~SqlOperation() {}
 };
 
@@ -51,6 +53,7 @@ class SqlPlainRequest : public SqlOperation
         SqlPlainRequest(const char* sql) : m_sql(mangos_strdup(sql)) {}
         ~SqlPlainRequest() { char* tofree = const_cast<char*>(m_sql); delete[] tofree; }
         bool Execute(SqlConnection* conn) override;
+        size_t DataSize() const override { return strlen(m_sql); }
 };
 
 class SqlTransaction : public SqlOperation
@@ -65,6 +68,12 @@ class SqlTransaction : public SqlOperation
         void DelayExecute(SqlOperation* sql) { m_queue.push_back(sql); }
 
         bool Execute(SqlConnection* conn) override;
+        size_t DataSize() const override;
+
+        size_t GetStatementsCount() const { return m_queue.size(); }
+
+    private:
+        bool ExecuteOnce(SqlConnection* conn);
 };
 
 class SqlPreparedRequest : public SqlOperation
@@ -74,6 +83,7 @@ class SqlPreparedRequest : public SqlOperation
         ~SqlPreparedRequest();
 
         bool Execute(SqlConnection* conn) override;
+        size_t DataSize() const override;
 
     private:
         const int m_nIndex;
@@ -122,7 +132,7 @@ class SqlQueryHolder
         void SetSize(size_t size);
         QueryResult* GetResult(size_t index);
         void SetResult(size_t index, QueryResult* result);
-        bool Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue);
+        bool Execute(MaNGOS::IQueryCallback* callback, SqlDelayQueue* delayQueue, uint64 orderKey, SqlResultQueue* queue);
 };
 
 class SqlQueryHolderEx : public SqlOperation
@@ -0,0 +1,178 @@
+/**
+ * This code is part of MaNGOS. Contributor & Copyright details are in AUTHORS/THANKS.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include "Platform/CompilerDefs.h"
+
+#if COMPILER == COMPILER_MICROSOFT
+#  include <windows.h>
+#endif
+
+#include <stddef.h>
+
+namespace ACE_Based
+{
+    //! Link of the elements of an MPSCQueue, elements derive from it.
+    class MPSCQueueNode
+    {
+            template<class T> friend class MPSCQueue;
+
+        protected:
+            MPSCQueueNode() : _next(NULL) {}
+
+        private:
+            MPSCQueueNode* volatile _next;
+    };
+
+    /**
+     * Lock-free queue of elements added by any thread and taken by one thread at a time.
+     *
+     * The elements are linked through their MPSCQueueNode, adding never allocates. Adding is
+     * one atomic exchange, taking needs none unless the queue runs empty. An element added
+     * while the last one is taken may only be seen by the next call.
+     */
+    template<class T>
+    class MPSCQueue
+    {
+        public:
+
+            //! Create an empty MPSCQueue.
+            MPSCQueue()
+                : _head(&_stub), _tail(&_stub), _peeked(NULL)
+            {
+            }
+
+            //! Adds an item to the queue, from any thread.
+            void add(T* item)
+            {
+                push(item);
+            }
+
+            //! Gets the next item in the queue, if any.
+            bool next(T*& result)
+            {
+                if (!_peeked)
+                    _peeked = pop();
+
+                if (!_peeked)
+                    return false;
+
+                result = _peeked;
+                _peeked = NULL;
+                return true;
+            }
+
+            //! Gets the next item in the queue if the checker accepts it, it stays queued otherwise.
+            template<class Checker>
+            bool next(T*& result, Checker& check)
+            {
+                if (!_peeked)
+                    _peeked = pop();
+
+                if (!_peeked || !check.Process(_peeked))
+                    return false;
+
+                result = _peeked;
+                _peeked = NULL;
+                return true;
+            }
+
+        private:
+            MPSCQueue(MPSCQueue const&);
+            MPSCQueue& operator=(MPSCQueue const&);
+
+            void push(MPSCQueueNode* node)
+            {
+                node->_next = NULL;
+                MPSCQueueNode* prev = exchangeHead(node);
+                storeRelease(prev->_next, node);
+            }
+
+            T* pop()
+            {
+                MPSCQueueNode* tail = _tail;
+                MPSCQueueNode* next = loadAcquire(tail->_next);
+
+                if (tail == &_stub)
+                {
+                    if (!next)
+                        return NULL;
+
+                    _tail = next;
+                    tail = next;
+                    next = loadAcquire(next->_next);
+                }
+
+                if (next)
+                {
+                    _tail = next;
+                    return static_cast<T*>(tail);
+                }
+
+                // a producer is between its exchange and linking the element
+                if (tail != loadAcquire(_head))
+                    return NULL;
+
+                // the last element can only be unlinked with a successor
+                push(&_stub);
+
+                next = loadAcquire(tail->_next);
+                if (next)
+                {
+                    _tail = next;
+                    return static_cast<T*>(tail);
+                }
+
+                return NULL;
+            }
+
+#if COMPILER == COMPILER_MICROSOFT
+            // interlocked operations are full barriers, volatile accesses acquire and release
+            MPSCQueueNode* exchangeHead(MPSCQueueNode* node)
+            {
+                return static_cast<MPSCQueueNode*>(InterlockedExchangePointer((PVOID volatile*)&_head, node));
+            }
+
+            static MPSCQueueNode* loadAcquire(MPSCQueueNode* volatile const& ptr) { return ptr; }
+            static void storeRelease(MPSCQueueNode* volatile& ptr, MPSCQueueNode* value) { ptr = value; }
+#else
+            MPSCQueueNode* exchangeHead(MPSCQueueNode* node)
+            {
+                return __atomic_exchange_n(&_head, node, __ATOMIC_ACQ_REL);
+            }
+
+            static MPSCQueueNode* loadAcquire(MPSCQueueNode* volatile const& ptr) { return __atomic_load_n(&ptr, __ATOMIC_ACQUIRE); }
+            static void storeRelease(MPSCQueueNode* volatile& ptr, MPSCQueueNode* value) { __atomic_store_n(&ptr, value, __ATOMIC_RELEASE); }
+#endif
+
+            //! Last added element, shared by the producers.
+            MPSCQueueNode* volatile _head;
+
+            //! Next element to take, only used by the consumer.
+            MPSCQueueNode* _tail;
+
+            //! Placeholder keeping the list linked while it is empty.
+            MPSCQueueNode _stub;
+
+            //! Element taken from the list but refused by a checker.
+            T* _peeked;
+    };
+}
+#endif